@@ -790,6 +790,9 @@ private:
 		arrConstVectorFactory[DT_DATASOURCE]=&ConstantFactory::createAnyVector;
 		arrConstVectorFactory[DT_COMPRESS]=NULL;
 
+		//UUID, INT128, IP and the string types have no array vector
+		for(int i=0; i<TYPE_COUNT; ++i)
+			arrConstArrayVectorFactory[i]=NULL;
 		arrConstArrayVectorFactory[DT_BOOL] 	= &ConstantFactory::createBoolArrayVector;
 		arrConstArrayVectorFactory[DT_CHAR] 	= &ConstantFactory::createCharArrayVector;
 		arrConstArrayVectorFactory[DT_SHORT] 	= &ConstantFactory::createShortArrayVector;
@@ -142,13 +142,14 @@ template<class T>
 class AbstractFastVector: public Vector{
 public:
 	AbstractFastVector(int size, int capacity, T* srcData, T nullVal, bool containNull):nullVal_(nullVal),size_(size),
-			capacity_(capacity), containNull_(containNull){
+			capacity_(capacity), containNull_(containNull), externalData_(false){
 		if(capacity<size)
 			capacity_=size;
 		data_ = srcData;
 	}
 	virtual ~AbstractFastVector(){
-		delete[] data_;
+		if(!externalData_)
+			delete[] data_;
 	}
 
 	virtual INDEX reserve(INDEX capacity){
@@ -156,7 +157,7 @@ public:
 			INDEX newCapacity= (std::max)((INDEX)(capacity_ * 1.2), capacity);
 			T* newData = new T[newCapacity];
 			memcpy(newData,data_,size_*sizeof(T));
-			delete[] data_;
+			releaseData();
 			data_=newData;
 			capacity_=newCapacity;
 		}
@@ -958,13 +959,22 @@ protected:
 			INDEX newCapacity= (size_+appendSize)*1.2;
 			T* newData = new T[newCapacity];
 			memcpy(newData,data_,size_*sizeof(T));
-			delete[] data_;
+			releaseData();
 			capacity_=newCapacity;
 			data_=newData;
 		}
 		return true;
 	}
 
+	//Free data_ unless it is borrowed from an external owner. A vector that grows copies the
+	//borrowed buffer into its own storage first, so the owner's memory is never reallocated.
+	void releaseData(){
+		if(externalData_)
+			externalData_ = false;
+		else
+			delete[] data_;
+	}
+
 	T* getDataArray(const Vector* indexVector, bool& hasNull) const {
 		INDEX len = indexVector->size();
 		T* buf = new T[len];
@@ -1081,6 +1091,7 @@ protected:
 	int capacity_;
 	bool containNull_;
 	DATA_TYPE dataType_;
+	bool externalData_; //data_ is owned by someone else, e.g. a NumPy array, and must not be freed
 };
 
 class FastBoolVector:public AbstractFastVector<char>{
@@ -2320,6 +2331,129 @@ private:
     bool blob_;
 };
 
+//String vector over one contiguous buffer of NUL-terminated strings, i.e. the wire format of a STRING vector.
+//offsets_[i] is the position of the i-th string and offsets_[size] the buffer length. Serializing a string column
+//built this way needs no per-row allocation and copies whole runs of bytes. Appending and removing at the end work
+//on the buffer; an edit in the middle goes through a StringVector and packs the result again, so it copies it all.
+class PackedStringVector: public AbstractStringVector{
+public:
+	PackedStringVector(vector<char>&& data, vector<long long>&& offsets, bool containNull, bool blob = false);
+	virtual ~PackedStringVector(){}
+	virtual DATA_TYPE getType() const {return blob_ ? DT_BLOB: DT_STRING;}
+	virtual DATA_TYPE getRawType() const { return blob_ ? DT_BLOB: DT_STRING;}
+	virtual DATA_CATEGORY getCategory() const {return blob_ ? BINARY : LITERAL;}
+	virtual INDEX getCapacity() const {return size();}
+	virtual bool isFastMode() const {return false;}
+	virtual short getUnitLength() const {return 0;}
+	virtual void clear(){
+		data_.clear();
+		offsets_.assign(1, 0);
+		containNull_ = false;
+	}
+	virtual bool sizeable() const {return true;}
+	virtual INDEX size() const {return offsets_.size() - 1;}
+	virtual int compare(INDEX index, const ConstantSP& target) const {
+		return -target->getString().compare(0, string::npos, data_.data() + offsets_[index], length(index));
+	}
+	virtual string getString(INDEX index) const {return string(data_.data() + offsets_[index], length(index));}
+	virtual ConstantSP get(INDEX index) const {return ConstantSP(new String(getString(index), blob_));}
+	virtual ConstantSP get(const ConstantSP& index) const;
+	virtual bool set(INDEX index, const ConstantSP& value){return edit([&](StringVector& strings){ return strings.set(index, value);});}
+	virtual bool set(const ConstantSP& index, const ConstantSP& value){return edit([&](StringVector& strings){ return strings.set(index, value);});}
+	virtual bool assign(const ConstantSP& value){return edit([&](StringVector& strings){ return strings.assign(value);});}
+	virtual bool isNull(INDEX index) const {return length(index) == 0;}
+	virtual bool isNull() const {return false;}
+	virtual void setNull(INDEX index){edit([&](StringVector& strings){ strings.setNull(index); return true;});}
+	virtual void setNull(){}
+	virtual bool hasNull(){return hasNull(0, size());}
+	virtual bool hasNull(INDEX start, INDEX length);
+	virtual void nullFill(const ConstantSP& val){edit([&](StringVector& strings){ strings.nullFill(val); return true;});}
+	virtual bool isNull(INDEX start, int len, char* buf) const;
+	virtual ConstantSP getSubVector(INDEX start, INDEX length) const { return getSubVector(start, length, std::abs(length));}
+	virtual ConstantSP getSubVector(INDEX start, INDEX length, INDEX capacity) const;
+	virtual ConstantSP getInstance(INDEX size) const {return ConstantSP(new StringVector(size, size, blob_));}
+	virtual ConstantSP getValue() const {return getValue(size());}
+	virtual ConstantSP getValue(INDEX capacity) const;
+	virtual bool append(const ConstantSP& value, INDEX appendSize);
+	virtual bool appendString(string* buf, int len);
+	virtual bool appendString(char** buf, int len);
+	virtual bool remove(INDEX count);
+	virtual bool remove(const ConstantSP& index){return edit([&](StringVector& strings){ return strings.remove(index);});}
+	virtual int serialize(char* buf, int bufSize, INDEX indexStart, int offset, int& numElement, int& partial) const;
+	virtual bool getString(INDEX start, int len, char** buf) const {
+		getStringConst(start, len, buf);
+		return true;
+	}
+	virtual char** getStringConst(INDEX start, int len, char** buf) const {
+		for(int i=0;i<len;++i)
+			buf[i] = (char*)data_.data() + offsets_[start + i];
+		return buf;
+	}
+	virtual void fill(INDEX start, INDEX length, const ConstantSP& value){edit([&](StringVector& strings){ strings.fill(start, length, value); return true;});}
+	virtual void next(INDEX steps){edit([&](StringVector& strings){ strings.next(steps); return true;});}
+	virtual void prev(INDEX steps){edit([&](StringVector& strings){ strings.prev(steps); return true;});}
+	virtual void reverse(){edit([&](StringVector& strings){ strings.reverse(); return true;});}
+	virtual void reverse(INDEX start, INDEX length){edit([&](StringVector& strings){ strings.reverse(start, length); return true;});}
+	virtual void replace(const ConstantSP& oldVal, const ConstantSP& newVal){edit([&](StringVector& strings){ strings.replace(oldVal, newVal); return true;});}
+	virtual void upper(){edit([&](StringVector& strings){ strings.upper(); return true;});}
+	virtual void lower(){edit([&](StringVector& strings){ strings.lower(); return true;});}
+	virtual void trim(){edit([&](StringVector& strings){ strings.trim(); return true;});}
+	virtual void strip(){edit([&](StringVector& strings){ strings.strip(); return true;});}
+	virtual long long getAllocatedMemory() const {return sizeof(PackedStringVector) + data_.capacity() + offsets_.capacity() * sizeof(long long);}
+	virtual bool getHash(INDEX start, int len, int buckets, int* buf) const {
+		for(int i=0; i<len; ++i)
+			buf[i] = murmur32(data_.data() + offsets_[start + i], length(start + i)) % buckets;
+		return true;
+	}
+	virtual int asof(const ConstantSP& value) const{
+		const string& target = value->getStringRef();
+		int start = 0;
+		int end = size() - 1;
+		int mid;
+		while(start <= end){
+			mid = (start + end) / 2;
+			if(target.compare(0, string::npos, data_.data() + offsets_[mid], length(mid)) >= 0){
+				start = mid + 1;
+			}
+			else {
+				end = mid - 1;
+			}
+		}
+		return end;
+	}
+
+private:
+	int length(INDEX index) const {return offsets_[index + 1] - offsets_[index] - 1;}
+	void appendRaw(const char* str, size_t len){
+		data_.insert(data_.end(), str, str + len);
+		data_.push_back(0);
+		offsets_.push_back(data_.size());
+	}
+	//Run a StringVector edit on the strings and pack the result again.
+	template<class F>
+	bool edit(F op){
+		StringVector strings(0, size(), blob_);
+		for(INDEX i=0; i<size(); ++i){
+			string str = getString(i);
+			strings.appendString(&str, 1);
+		}
+		strings.setNullFlag(containNull_);
+		bool ret = op(strings);
+		clear();
+		for(INDEX i=0; i<strings.size(); ++i){
+			const string& str = strings.getStringRef(i);
+			appendRaw(str.data(), str.size());
+		}
+		containNull_ = strings.getNullFlag();
+		return ret;
+	}
+
+private:
+	vector<char> data_;
+	vector<long long> offsets_;
+	bool blob_;
+};
+
 class FastFixedLengthVector : public Vector {
 public:
 	FastFixedLengthVector(DATA_TYPE type, int fixedLength, int size, int capacity, unsigned char* srcData, bool containNull);
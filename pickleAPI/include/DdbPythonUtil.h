@@ -88,11 +88,17 @@ public:
     };
     struct ToPythonOption{
         bool table2List;//if object is table, false: convert to pandas, true: convert to list
+        bool nullableDtype;//BOOL/CHAR/SHORT/INT/LONG vectors to pandas boolean/Int8/Int16/Int32/Int64 arrays instead of float64 when null
+        bool symbolAsCategory;//SYMBOL vectors to pandas.Categorical instead of object arrays
         ToPythonOption(){
             table2List = false;
+            nullableDtype = false;
+            symbolAsCategory = false;
         }
         ToPythonOption(bool table2Lista){
             table2List = table2Lista;
+            nullableDtype = false;
+            symbolAsCategory = false;
         }
     };
 
@@ -103,6 +109,10 @@ public:
     static void toDolphinDBScalar(const py::object *obj, int size, DATA_TYPE type, vector<ConstantSP> &result);
     static py::object toPython(ConstantSP obj, bool tableFlag=false, const ToPythonOption *poption = NULL);
     static py::object loadPickleFile(const std::string &filepath);
+    //Load many pickle files. Worker threads read a group of files from disk in parallel, then the group is unpickled.
+    static py::list loadPickleFiles(const vector<std::string> &filepaths);
+    //(schema capsule, array capsule) of the Arrow PyCapsule interface
+    static py::tuple toArrow(const ConstantSP &obj);
     static void createPyVector(const ConstantSP &obj,py::object &pyObject,bool tableFlag,const ToPythonOption *poption);
 protected:
     friend class PytoDdbRowPool;
@@ -126,6 +136,9 @@ public:
         nonempty_.set();
         return true;
     }
+    //Insert columns converted by the caller after converting the rows still queued, so they keep their order.
+    //Returns false if the writer is exiting.
+    bool insertColumns(const vector<ConstantSP> &columns);
     void getStatus(MultithreadedTableWriter::Status &status);
     void getUnwrittenData(vector<vector<py::object>*> &pyData,vector<vector<ConstantSP>*> &ddbData);
 
@@ -141,6 +154,7 @@ public:
 private:
     friend class ConvertExecutor;
     void convertLoop();
+    void convert(vector<std::vector<py::object>*> &convertRows);
     MultithreadedTableWriter &writer_;
     ThreadSP thread_;
     bool exitWhenEmpty_;
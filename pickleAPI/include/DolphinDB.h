@@ -67,6 +67,7 @@ class DBConnectionImpl;
 class BlockReader;
 class Domain; 
 class DBConnectionPoolImpl;
+class PoolEventLoop;
 class PartitionedTableAppender;
 class SymbolBase;
 class Mutex;
@@ -703,10 +704,12 @@ public:
 	/**
 	 * Connect to the specified DolphinDB server. If userId and password are specified, authentication
 	 * will be performed along with connecting. If one would send userId and password in encrypted mode,
-	 * please use the login function for authentication separately.
+	 * please use the login function for authentication separately. If unixSocket is given, the connection goes
+	 * through that Unix domain socket of a server on the same host instead of TCP. Switching to another node
+	 * in high availability mode uses TCP.
 	 */
 	bool connect(const string& hostName, int port, const string& userId = "", const string& password = "", const string& initialScript = "",
-			bool highAvailability = false, const vector<string>& highAvailabilitySites = vector<string>());
+			bool highAvailability = false, const vector<string>& highAvailabilitySites = vector<string>(), const string& unixSocket = "");
 
 	/**
 	 * Log onto the DolphinDB server using the given userId and password. If the parameter enableEncryption
@@ -722,14 +725,20 @@ public:
 	 * exception.
 	 */
 	ConstantSP run(const string& script, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory=false);
-    py::object runPy(const string& script, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory=false,bool pickleTableToList=false);
+    py::object runPy(const string& script, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory=false,bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false);
 	/**
 	 * Run the given function on the DolphinDB server using the local objects as the arguments
 	 * for the function and return the result to the client. If nothing returns, the function
 	 * returns a void object. If error is raised on the server, the function throws an exception.
 	 */
 	ConstantSP run(const string& funcName, vector<ConstantSP>& args, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory=false);
-    py::object runPy(const string& funcName, vector<ConstantSP>& args, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory=false,bool pickleTableToList=false);
+    py::object runPy(const string& funcName, vector<ConstantSP>& args, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory=false,bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false);
+	/**
+	 * Run the scripts in order, writing their requests back to back instead of waiting a round trip for each response.
+	 * The results are returned in the same order. If a script raises an error on the server, the other scripts still
+	 * run and the first error is thrown once all responses have been read.
+	 */
+    py::list runPyPipelined(const vector<string>& scripts, int priority=4, int parallelism=2, bool clearMemory=false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false);
 	/**
 	 * upload a local object to the DolphinDB server and assign the given name in the session.
 	 */
@@ -769,6 +778,7 @@ public:
     bool connected();
 
 private:
+    friend class PoolEventLoop;
     std::unique_ptr<DBConnectionImpl> conn_;
     string uid_;
     string pwd_;
@@ -803,14 +813,22 @@ private:
 
 class EXPORT_DECL DBConnectionPool{
 public:
+    /**
+     * With eventLoopThreads > 0 the threadNum connections are driven by that many threads waiting on epoll instead of
+     * one worker thread per connection. Each of them has a few IO threads that write the requests and decode the
+     * responses. eventLoopThreads doesn't bound the total thread count: the IO threads of all loops together come
+     * to about the core count, at least one per loop and never more than the loop's connections. Windows always
+     * uses one thread per connection.
+     */
     DBConnectionPool(const string& hostName, int port, int threadNum = 10, const string& userId = "", const string& password = "",
-					bool loadBalance = false, bool highAvailability = false,  bool reConectFlag = true, bool compress = false, bool enablePickle=true);
+					bool loadBalance = false, bool highAvailability = false,  bool reConectFlag = true, bool compress = false, bool enablePickle=true,
+					int eventLoopThreads = 0);
     
 	void run(const string& script, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false);
     
 	void run(const string& functionName, const vector<ConstantSP>& args, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false);
-    void runPy(const string& script, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false, bool pickleTableToList=false);
-    void runPy(const string& functionName, const vector<ConstantSP>& args, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false, bool pickleTableToList=false);
+    void runPy(const string& script, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false);
+    void runPy(const string& functionName, const vector<ConstantSP>& args, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false);
     bool isFinished(int identity);
     
 	ConstantSP getData(int identity);
@@ -63,6 +63,9 @@ public:
     void getUnwrittenData(std::vector<std::vector<ConstantSP>*> &unwrittenData);
     void insert(std::vector<ConstantSP> **records, int recordCount);
 	void insertUnwrittenData(std::vector<std::vector<ConstantSP>*> &records) { insert(records.data(), records.size()); }
+	//Queue rows given as one vector per column behind the rows inserted before. The vectors have the column
+	//types and the same length, they are written as they are instead of being split into rows.
+	void insertColumns(const std::vector<ConstantSP> &columns);
     void waitForThreadCompletion();
     bool isExit(){ return hasError_.load(); }
 
@@ -108,19 +111,33 @@ private:
 			dataType = (DATA_TYPE)(dataType - ARRAY_TYPE_BASE);
 		return dataType;
 	}
+	//A queued insert: one row of scalars, an array vector cell being a vector wrapped in an any vector,
+	//or if rows > 0, that many rows given as one vector per column.
+	struct WriteItem{
+		std::vector<ConstantSP> *values;
+		INDEX rows;
+	};
+	struct WriterThread;
 	void insertThreadWrite(int threadhashkey, std::vector<ConstantSP> *prow);
+	void pushItem(WriterThread &writerThread, const WriteItem &item);
+	void popItems(WriterThread &writerThread, std::vector<WriteItem> &items, int count);
+	long getQueuedRows(WriterThread &writerThread);
+	void splitItem(const WriteItem &item, std::vector<std::vector<ConstantSP>*> &rows);
 
     struct WriterThread{
         SmartPointer<DBConnection> conn;
         
-        SynchronizedQueue<std::vector<ConstantSP>*> writeQueue;
-        SynchronizedQueue<std::vector<ConstantSP>*> failedQueue;
+        SynchronizedQueue<WriteItem> writeQueue;
+        SynchronizedQueue<WriteItem> failedQueue;
         ThreadSP writeThread;
         ConditionalNotifier nonemptyNotify;
 
         Semaphore idleSem;
         unsigned int threadId;
-        long sentRows, sendingRows;
+        long sentRows, sendingRows, failedRows;
+		//rows in writeQueue, guarded by queuedMutex
+		Mutex queuedMutex;
+		long queuedRows;
 		bool exit;
     };
     class SendExecutor : public dolphindb::Runnable {
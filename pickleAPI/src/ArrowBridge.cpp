@@ -0,0 +1,952 @@
+/*
+ * ArrowBridge.cpp
+ *
+ * See ArrowBridge.h for the layout of the exported and imported arrays.
+ */
+
+#include <string.h>
+#include <deque>
+
+#include "ArrowBridge.h"
+#include "ConstantImp.h"
+#include "Util.h"
+
+namespace dolphindb {
+
+static const char* EXTENSION_NAME_KEY = "ARROW:extension:name";
+static const char* EXTENSION_METADATA_KEY = "ARROW:extension:metadata";
+
+static inline bool isValid(const unsigned char* validity, int64_t index) {
+	return validity == NULL || (validity[index >> 3] >> (index & 7)) & 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// export
+//////////////////////////////////////////////////////////////////////////////
+
+struct ExportedSchema {
+	string format;
+	string name;
+	string metadata;
+	vector<ArrowSchema> children;
+	vector<ArrowSchema*> childPointers;
+	ArrowSchema dictionary;
+};
+
+struct ExportedArray {
+	//keeps the memory shared with the consumer alive
+	ConstantSP owner;
+	vector<const void*> buffers;
+	//buffers which had to be converted
+	vector<vector<char>> copies;
+	vector<ArrowArray> children;
+	vector<ArrowArray*> childPointers;
+	ArrowArray dictionary;
+};
+
+static void releaseSchema(ArrowSchema* schema) {
+	if (schema->release == NULL)
+		return;
+	for (int64_t i = 0; i < schema->n_children; ++i) {
+		ArrowSchema* child = schema->children[i];
+		if (child->release != NULL)
+			child->release(child);
+	}
+	if (schema->dictionary != NULL && schema->dictionary->release != NULL)
+		schema->dictionary->release(schema->dictionary);
+	delete (ExportedSchema*)schema->private_data;
+	schema->release = NULL;
+}
+
+static void releaseArray(ArrowArray* array) {
+	if (array->release == NULL)
+		return;
+	for (int64_t i = 0; i < array->n_children; ++i) {
+		ArrowArray* child = array->children[i];
+		if (child->release != NULL)
+			child->release(child);
+	}
+	if (array->dictionary != NULL && array->dictionary->release != NULL)
+		array->dictionary->release(array->dictionary);
+	delete (ExportedArray*)array->private_data;
+	array->release = NULL;
+}
+
+static ExportedSchema* initSchema(ArrowSchema* schema, const string& format, const string& name, int nChildren) {
+	ExportedSchema* priv = new ExportedSchema();
+	priv->format = format;
+	priv->name = name;
+	priv->children.resize(nChildren);
+	for (int i = 0; i < nChildren; ++i) {
+		priv->children[i].release = NULL;
+		priv->childPointers.push_back(&priv->children[i]);
+	}
+	priv->dictionary.release = NULL;
+	schema->format = priv->format.c_str();
+	schema->name = priv->name.c_str();
+	schema->metadata = NULL;
+	schema->flags = ARROW_FLAG_NULLABLE;
+	schema->n_children = nChildren;
+	schema->children = nChildren > 0 ? priv->childPointers.data() : NULL;
+	schema->dictionary = NULL;
+	schema->release = releaseSchema;
+	schema->private_data = priv;
+	return priv;
+}
+
+static ExportedArray* initArray(ArrowArray* array, const ConstantSP& owner, int64_t length, int nBuffers, int nChildren) {
+	ExportedArray* priv = new ExportedArray();
+	priv->owner = owner;
+	priv->buffers.resize(nBuffers, NULL);
+	priv->children.resize(nChildren);
+	for (int i = 0; i < nChildren; ++i) {
+		priv->children[i].release = NULL;
+		priv->childPointers.push_back(&priv->children[i]);
+	}
+	priv->dictionary.release = NULL;
+	array->length = length;
+	array->null_count = 0;
+	array->offset = 0;
+	array->n_buffers = nBuffers;
+	array->n_children = nChildren;
+	array->buffers = priv->buffers.data();
+	array->children = nChildren > 0 ? priv->childPointers.data() : NULL;
+	array->dictionary = NULL;
+	array->release = releaseArray;
+	array->private_data = priv;
+	return priv;
+}
+
+static char* allocate(ExportedArray* priv, size_t bytes) {
+	priv->copies.emplace_back(bytes == 0 ? 1 : bytes, 0);
+	return priv->copies.back().data();
+}
+
+//Extension type metadata: int32 pair count, then int32 length + bytes for each key and value.
+static string extensionMetadata(const string& name) {
+	string buf;
+	auto appendInt = [&buf](int value) { buf.append((const char*)&value, sizeof(int)); };
+	auto appendString = [&](const string& str) { appendInt((int)str.size()); buf.append(str); };
+	appendInt(2);
+	appendString(EXTENSION_NAME_KEY);
+	appendString(name);
+	appendString(EXTENSION_METADATA_KEY);
+	appendString("");
+	return buf;
+}
+
+static void setValidity(ArrowArray* array, ExportedArray* priv, unsigned char* bitmap, int64_t nullCount) {
+	array->null_count = nullCount;
+	priv->buffers[0] = nullCount > 0 ? bitmap : NULL;
+}
+
+//Validity bitmap from the null flags of a vector.
+static void exportValidity(const VectorSP& vec, ArrowArray* array, ExportedArray* priv) {
+	if (vec->isFastMode() && !vec->getNullFlag())
+		return;
+	INDEX size = vec->size();
+	unsigned char* bitmap = (unsigned char*)allocate(priv, (size + 7) / 8);
+	char nulls[Util::BUF_SIZE];
+	int64_t nullCount = 0;
+	for (INDEX start = 0; start < size; start += Util::BUF_SIZE) {
+		int len = std::min(Util::BUF_SIZE, size - start);
+		vec->isNull(start, len, nulls);
+		for (int i = 0; i < len; ++i) {
+			if (nulls[i])
+				++nullCount;
+			else
+				bitmap[(start + i) >> 3] |= 1 << ((start + i) & 7);
+		}
+	}
+	setValidity(array, priv, bitmap, nullCount);
+}
+
+//The memory of a fixed-width vector, shared if possible.
+static const void* fixedWidthData(const VectorSP& vec, int unitLength, ExportedArray* priv) {
+	INDEX size = vec->size();
+	if (vec->isFastMode()) {
+		if (vec->getDataArray() != NULL)
+			return vec->getDataArray();
+		if (vec->getCategory() == BINARY)
+			return vec->getBinaryConst(0, size, unitLength, NULL);
+	}
+	char* buf = allocate(priv, (size_t)size * unitLength);
+	bool ok;
+	switch (vec->getRawType()) {
+		case DT_BOOL:
+		case DT_CHAR: ok = vec->getChar(0, size, buf); break;
+		case DT_SHORT: ok = vec->getShort(0, size, (short*)buf); break;
+		case DT_INT: ok = vec->getInt(0, size, (int*)buf); break;
+		case DT_LONG: ok = vec->getLong(0, size, (long long*)buf); break;
+		case DT_FLOAT: ok = vec->getFloat(0, size, (float*)buf); break;
+		case DT_DOUBLE: ok = vec->getDouble(0, size, (double*)buf); break;
+		default: ok = vec->getBinary(0, size, unitLength, (unsigned char*)buf); break;
+	}
+	if (!ok)
+		throw RuntimeException("Failed to read the data of " + Util::getDataTypeString(vec->getType()) + " vector.");
+	return buf;
+}
+
+//Temporal values whose unit has no Arrow counterpart of the same width are scaled into a wider type.
+template <typename T>
+static const void* scaleTemporal(const VectorSP& vec, long long factor, ExportedArray* priv) {
+	INDEX size = vec->size();
+	T* dst = (T*)allocate(priv, (size_t)size * sizeof(T));
+	int buf[Util::BUF_SIZE];
+	for (INDEX start = 0; start < size; start += Util::BUF_SIZE) {
+		int len = std::min(Util::BUF_SIZE, size - start);
+		const int* src = vec->getIntConst(start, len, buf);
+		for (int i = 0; i < len; ++i)
+			dst[start + i] = src[i] == INT_MIN ? 0 : (T)((long long)src[i] * factor);
+	}
+	return dst;
+}
+
+static const void* monthToDate(const VectorSP& vec, ExportedArray* priv) {
+	INDEX size = vec->size();
+	int* dst = (int*)allocate(priv, (size_t)size * sizeof(int));
+	int buf[Util::BUF_SIZE];
+	for (INDEX start = 0; start < size; start += Util::BUF_SIZE) {
+		int len = std::min(Util::BUF_SIZE, size - start);
+		const int* src = vec->getIntConst(start, len, buf);
+		for (int i = 0; i < len; ++i)
+			dst[start + i] = src[i] == INT_MIN ? 0 : Util::countDays(src[i] / 12, src[i] % 12 + 1, 1);
+	}
+	return dst;
+}
+
+static const void* boolToBits(const VectorSP& vec, ExportedArray* priv) {
+	INDEX size = vec->size();
+	unsigned char* dst = (unsigned char*)allocate(priv, (size + 7) / 8);
+	char buf[Util::BUF_SIZE];
+	for (INDEX start = 0; start < size; start += Util::BUF_SIZE) {
+		int len = std::min(Util::BUF_SIZE, size - start);
+		const char* src = vec->getBoolConst(start, len, buf);
+		for (int i = 0; i < len; ++i) {
+			if (src[i] != 0 && src[i] != CHAR_MIN)
+				dst[(start + i) >> 3] |= 1 << ((start + i) & 7);
+		}
+	}
+	return dst;
+}
+
+//DolphinDB keeps a UUID as a little-endian 128-bit integer, arrow.uuid expects the RFC 4122 byte order.
+static const void* uuidToBigEndian(const VectorSP& vec, ExportedArray* priv) {
+	INDEX size = vec->size();
+	const unsigned char* src = (const unsigned char*)fixedWidthData(vec, 16, priv);
+#ifndef BIGENDIANNESS
+	unsigned char* dst = (unsigned char*)allocate(priv, (size_t)size * 16);
+	for (INDEX i = 0; i < size; ++i) {
+		for (int j = 0; j < 16; ++j)
+			dst[i * 16 + j] = src[i * 16 + 15 - j];
+	}
+	return dst;
+#else
+	return src;
+#endif
+}
+
+//utf8 (or binary for BLOB) with int32 offsets, int64 offsets if the data doesn't fit.
+static string exportStrings(const VectorSP& vec, ArrowArray* array, ExportedArray* priv) {
+	INDEX size = vec->size();
+	bool blob = vec->getType() == DT_BLOB;
+	vector<string> blobs;
+	vector<const char*> strs(size);
+	vector<int64_t> lengths(size);
+	int64_t total = 0;
+	if (blob) {
+		blobs.resize(size);
+		for (INDEX i = 0; i < size; ++i) {
+			blobs[i] = vec->getString(i);
+			strs[i] = blobs[i].data();
+			lengths[i] = blobs[i].size();
+			total += lengths[i];
+		}
+	}
+	else {
+		char* buf[Util::BUF_SIZE];
+		for (INDEX start = 0; start < size; start += Util::BUF_SIZE) {
+			int len = std::min(Util::BUF_SIZE, size - start);
+			char** src = vec->getStringConst(start, len, buf);
+			for (int i = 0; i < len; ++i) {
+				strs[start + i] = src[i];
+				lengths[start + i] = strlen(src[i]);
+				total += lengths[start + i];
+			}
+		}
+	}
+
+	bool large = total > INT_MAX;
+	unsigned char* bitmap = (unsigned char*)allocate(priv, (size + 7) / 8);
+	char* offsets = allocate(priv, (size_t)(size + 1) * (large ? sizeof(int64_t) : sizeof(int)));
+	char* data = allocate(priv, total);
+	int64_t nullCount = 0;
+	int64_t pos = 0;
+	for (INDEX i = 0; i < size; ++i) {
+		if (large)
+			((int64_t*)offsets)[i] = pos;
+		else
+			((int*)offsets)[i] = (int)pos;
+		if (lengths[i] == 0) {
+			++nullCount;
+			continue;
+		}
+		bitmap[i >> 3] |= 1 << (i & 7);
+		memcpy(data + pos, strs[i], lengths[i]);
+		pos += lengths[i];
+	}
+	if (large)
+		((int64_t*)offsets)[size] = pos;
+	else
+		((int*)offsets)[size] = (int)pos;
+	setValidity(array, priv, bitmap, nullCount);
+	priv->buffers[1] = offsets;
+	priv->buffers[2] = data;
+	if (blob)
+		return large ? "Z" : "z";
+	return large ? "U" : "u";
+}
+
+static void exportVector(const VectorSP& vec, const string& name, ArrowSchema* schema, ArrowArray* array);
+
+//SYMBOL: int32 indices shared with the vector plus a utf8 dictionary built from the symbol base.
+static void exportSymbols(const VectorSP& vec, const SymbolBaseSP& base, const string& name, ArrowSchema* schema, ArrowArray* array) {
+	ExportedSchema* schemaPriv = initSchema(schema, "i", name, 0);
+	ExportedArray* arrayPriv = initArray(array, vec, vec->size(), 2, 0);
+	const int* indices = (const int*)vec->getDataArray();
+	INDEX size = vec->size();
+	unsigned char* bitmap = (unsigned char*)allocate(arrayPriv, (size + 7) / 8);
+	int64_t nullCount = 0;
+	for (INDEX i = 0; i < size; ++i) {
+		if (indices[i] == 0)
+			++nullCount;
+		else
+			bitmap[i >> 3] |= 1 << (i & 7);
+	}
+	setValidity(array, arrayPriv, bitmap, nullCount);
+	arrayPriv->buffers[1] = indices;
+
+	int count = base->size();
+	VectorSP dict = Util::createVector(DT_STRING, count);
+	for (int i = 0; i < count; ++i)
+		dict->setString(i, base->getSymbol(i));
+	exportVector(dict, "", &schemaPriv->dictionary, &arrayPriv->dictionary);
+	schema->dictionary = &schemaPriv->dictionary;
+	array->dictionary = &arrayPriv->dictionary;
+}
+
+static void exportArrayVector(const VectorSP& vec, const string& name, ArrowSchema* schema, ArrowArray* array) {
+	FastArrayVector* arrayVector = (FastArrayVector*)vec.get();
+	const INDEX* index = arrayVector->getIndexArray();
+	VectorSP values = arrayVector->getFlatValueArray();
+	INDEX size = vec->size();
+	ExportedSchema* schemaPriv = initSchema(schema, "+l", name, 1);
+	ExportedArray* arrayPriv = initArray(array, vec, size, 2, 1);
+	int* offsets = (int*)allocate(arrayPriv, (size_t)(size + 1) * sizeof(int));
+	memcpy(offsets + 1, index, (size_t)size * sizeof(int));
+	arrayPriv->buffers[1] = offsets;
+	exportVector(values, "item", schemaPriv->childPointers[0], arrayPriv->childPointers[0]);
+}
+
+static void exportVector(const VectorSP& vec, const string& name, ArrowSchema* schema, ArrowArray* array) {
+	DATA_TYPE type = vec->getType();
+	if (type >= ARRAY_TYPE_BASE) {
+		exportArrayVector(vec, name, schema, array);
+		return;
+	}
+	if (type == DT_SYMBOL && vec->isFastMode() && !vec->getSymbolBase().isNull()) {
+		exportSymbols(vec, vec->getSymbolBase(), name, schema, array);
+		return;
+	}
+
+	ExportedArray* priv;
+	switch (type) {
+		case DT_STRING:
+		case DT_SYMBOL:
+		case DT_BLOB: {
+			priv = initArray(array, vec, vec->size(), 3, 0);
+			initSchema(schema, exportStrings(vec, array, priv), name, 0);
+			return;
+		}
+		default:
+			break;
+	}
+
+	string format;
+	string metadata;
+	const void* data = NULL;
+	priv = initArray(array, vec, vec->size(), 2, 0);
+	switch (type) {
+		case DT_BOOL: format = "b"; data = boolToBits(vec, priv); break;
+		case DT_CHAR: format = "c"; data = fixedWidthData(vec, 1, priv); break;
+		case DT_SHORT: format = "s"; data = fixedWidthData(vec, 2, priv); break;
+		case DT_INT: format = "i"; data = fixedWidthData(vec, 4, priv); break;
+		case DT_LONG: format = "l"; data = fixedWidthData(vec, 8, priv); break;
+		case DT_FLOAT: format = "f"; data = fixedWidthData(vec, 4, priv); break;
+		case DT_DOUBLE: format = "g"; data = fixedWidthData(vec, 8, priv); break;
+		case DT_DATE: format = "tdD"; data = fixedWidthData(vec, 4, priv); break;
+		case DT_MONTH: format = "tdD"; data = monthToDate(vec, priv); break;
+		case DT_TIME: format = "ttm"; data = fixedWidthData(vec, 4, priv); break;
+		case DT_MINUTE: format = "tts"; data = scaleTemporal<int>(vec, 60, priv); break;
+		case DT_SECOND: format = "tts"; data = fixedWidthData(vec, 4, priv); break;
+		case DT_DATETIME: format = "tss:"; data = scaleTemporal<long long>(vec, 1, priv); break;
+		case DT_DATEHOUR: format = "tss:"; data = scaleTemporal<long long>(vec, 3600, priv); break;
+		case DT_DATEMINUTE: format = "tss:"; data = scaleTemporal<long long>(vec, 60, priv); break;
+		case DT_TIMESTAMP: format = "tsm:"; data = fixedWidthData(vec, 8, priv); break;
+		case DT_NANOTIME: format = "ttn"; data = fixedWidthData(vec, 8, priv); break;
+		case DT_NANOTIMESTAMP: format = "tsn:"; data = fixedWidthData(vec, 8, priv); break;
+		case DT_UUID:
+			format = "w:16";
+			metadata = extensionMetadata("arrow.uuid");
+			data = uuidToBigEndian(vec, priv);
+			break;
+		case DT_IP:
+			format = "w:16";
+			metadata = extensionMetadata("dolphindb.ipaddr");
+			data = fixedWidthData(vec, 16, priv);
+			break;
+		case DT_INT128:
+			format = "w:16";
+			metadata = extensionMetadata("dolphindb.int128");
+			data = fixedWidthData(vec, 16, priv);
+			break;
+		default:
+			throw RuntimeException("Cannot convert " + Util::getDataTypeString(type) + " vector to Arrow.");
+	}
+	exportValidity(vec, array, priv);
+	priv->buffers[1] = data;
+	ExportedSchema* schemaPriv = initSchema(schema, format, name, 0);
+	if (!metadata.empty()) {
+		schemaPriv->metadata = metadata;
+		schema->metadata = schemaPriv->metadata.data();
+	}
+}
+
+static void exportTable(const TableSP& table, ArrowSchema* schema, ArrowArray* array) {
+	int cols = table->columns();
+	ExportedSchema* schemaPriv = initSchema(schema, "+s", "", cols);
+	schema->flags = 0;
+	ExportedArray* arrayPriv = initArray(array, table, table->size(), 1, cols);
+	for (int i = 0; i < cols; ++i)
+		exportVector(table->getColumn(i), table->getColumnName(i), schemaPriv->childPointers[i], arrayPriv->childPointers[i]);
+}
+
+void ArrowBridge::exportConstant(const ConstantSP& obj, ArrowSchema* schema, ArrowArray* array) {
+	schema->release = NULL;
+	array->release = NULL;
+	try {
+		if (obj->isTable()) {
+			exportTable(obj, schema, array);
+		}
+		else if (obj->isVector()) {
+			exportVector(obj, "", schema, array);
+		}
+		else if (obj->isScalar()) {
+			VectorSP vec = Util::createVector(obj->getType(), 0, 1);
+			vec->append(obj);
+			exportVector(vec, "", schema, array);
+		}
+		else {
+			throw RuntimeException("Cannot convert " + Util::getDataFormString(obj->getForm()) + " to Arrow.");
+		}
+	}
+	catch (...) {
+		if (schema->release != NULL)
+			schema->release(schema);
+		if (array->release != NULL)
+			array->release(array);
+		throw;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// import
+//////////////////////////////////////////////////////////////////////////////
+
+//Owns a moved ArrowArray and releases it when the last vector borrowing its buffers is gone.
+class ArrowArrayHolder {
+public:
+	ArrowArrayHolder(ArrowArray* array) : array_(*array) {
+		array->release = NULL;
+	}
+	~ArrowArrayHolder() {
+		if (array_.release != NULL)
+			array_.release(&array_);
+	}
+	const ArrowArray* get() const { return &array_; }
+private:
+	ArrowArray array_;
+};
+
+typedef SmartPointer<ArrowArrayHolder> ArrowArrayHolderSP;
+
+//Fast vector which serializes straight from the buffer of an Arrow array.
+template <class BaseVector, typename T>
+class ArrowBorrowedVector : public BaseVector {
+public:
+	ArrowBorrowedVector(const ArrowArrayHolderSP& holder, const T* data, int size) : BaseVector(size, size, (T*)data, false), holder_(holder) {
+		this->externalData_ = true;
+	}
+	virtual ~ArrowBorrowedVector(){}
+private:
+	ArrowArrayHolderSP holder_;
+};
+
+static const unsigned char* validityOf(const ArrowArray* array) {
+	if (array->null_count == 0 || array->n_buffers == 0)
+		return NULL;
+	return (const unsigned char*)array->buffers[0];
+}
+
+//Borrow the buffer if the array has no nulls, otherwise copy it and write the null value.
+template <class VectorType, typename T>
+static Vector* importFixedWidth(const ArrowArray* array, const ArrowArrayHolderSP& holder, T nullValue) {
+	int length = (int)array->length;
+	const T* data = (const T*)array->buffers[1] + array->offset;
+	const unsigned char* validity = validityOf(array);
+	if (validity == NULL)
+		return new ArrowBorrowedVector<VectorType, T>(holder, data, length);
+	T* buf = new T[length];
+	bool containNull = false;
+	for (int i = 0; i < length; ++i) {
+		if (isValid(validity, array->offset + i)) {
+			buf[i] = data[i];
+		}
+		else {
+			buf[i] = nullValue;
+			containNull = true;
+		}
+	}
+	return new VectorType(length, length, buf, containNull);
+}
+
+template <class VectorType, typename S, typename T, class Convert>
+static Vector* importConverted(const ArrowArray* array, T nullValue, Convert convert) {
+	int length = (int)array->length;
+	const S* data = (const S*)array->buffers[1] + array->offset;
+	const unsigned char* validity = validityOf(array);
+	T* buf = new T[length];
+	bool containNull = false;
+	for (int i = 0; i < length; ++i) {
+		if (isValid(validity, array->offset + i)) {
+			buf[i] = convert(data[i]);
+		}
+		else {
+			buf[i] = nullValue;
+			containNull = true;
+		}
+	}
+	return new VectorType(length, length, buf, containNull);
+}
+
+static inline long long floorDivide(long long value, long long divisor) {
+	long long quotient = value / divisor;
+	return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+static Vector* importBool(const ArrowArray* array) {
+	int length = (int)array->length;
+	const unsigned char* bits = (const unsigned char*)array->buffers[1];
+	const unsigned char* validity = validityOf(array);
+	char* buf = new char[length];
+	bool containNull = false;
+	for (int i = 0; i < length; ++i) {
+		int64_t index = array->offset + i;
+		if (isValid(validity, index)) {
+			buf[i] = (bits[index >> 3] >> (index & 7)) & 1;
+		}
+		else {
+			buf[i] = CHAR_MIN;
+			containNull = true;
+		}
+	}
+	return new FastBoolVector(length, length, buf, containNull);
+}
+
+static string extensionName(const ArrowSchema* schema) {
+	if (schema->metadata == NULL)
+		return "";
+	const char* p = schema->metadata;
+	int count;
+	memcpy(&count, p, sizeof(int));
+	p += sizeof(int);
+	for (int i = 0; i < count; ++i) {
+		int len;
+		memcpy(&len, p, sizeof(int));
+		string key(p + sizeof(int), len);
+		p += sizeof(int) + len;
+		memcpy(&len, p, sizeof(int));
+		string value(p + sizeof(int), len);
+		p += sizeof(int) + len;
+		if (key == EXTENSION_NAME_KEY)
+			return value;
+	}
+	return "";
+}
+
+static Vector* importInt128(const ArrowSchema* schema, const ArrowArray* array) {
+	string extension = extensionName(schema);
+	int length = (int)array->length;
+	const unsigned char* data = (const unsigned char*)array->buffers[1] + array->offset * 16;
+	const unsigned char* validity = validityOf(array);
+	unsigned char* buf = new unsigned char[(size_t)length * 16];
+	bool reverse = false;
+	DATA_TYPE type = DT_INT128;
+	if (extension == "arrow.uuid") {
+		type = DT_UUID;
+#ifndef BIGENDIANNESS
+		reverse = true;
+#endif
+	}
+	else if (extension == "dolphindb.ipaddr") {
+		type = DT_IP;
+	}
+	bool containNull = false;
+	for (int i = 0; i < length; ++i) {
+		unsigned char* dst = buf + i * 16;
+		if (!isValid(validity, array->offset + i)) {
+			memset(dst, 0, 16);
+			containNull = true;
+		}
+		else if (reverse) {
+			for (int j = 0; j < 16; ++j)
+				dst[j] = data[i * 16 + 15 - j];
+		}
+		else {
+			memcpy(dst, data + i * 16, 16);
+		}
+	}
+	if (type == DT_UUID)
+		return new FastUuidVector(length, length, buf, containNull);
+	if (type == DT_IP)
+		return new FastIPAddrVector(length, length, buf, containNull);
+	return new FastInt128Vector(DT_INT128, length, length, buf, containNull);
+}
+
+template <typename OffsetType>
+static Vector* importStrings(const ArrowArray* array, bool blob) {
+	int length = (int)array->length;
+	const OffsetType* offsets = (const OffsetType*)array->buffers[1] + array->offset;
+	const char* data = (const char*)array->buffers[2];
+	const unsigned char* validity = validityOf(array);
+	vector<char> buf;
+	buf.reserve((size_t)(offsets[length] - offsets[0]) + length);
+	vector<long long> positions(length + 1);
+	bool containNull = false;
+	for (int i = 0; i < length; ++i) {
+		positions[i] = buf.size();
+		if (isValid(validity, array->offset + i))
+			buf.insert(buf.end(), data + offsets[i], data + offsets[i + 1]);
+		if (buf.size() == (size_t)positions[i])
+			containNull = true;
+		buf.push_back(0);
+	}
+	positions[length] = buf.size();
+	return new PackedStringVector(std::move(buf), std::move(positions), containNull, blob);
+}
+
+template <typename OffsetType>
+static void decodeDictionary(const ArrowArray* array, const SymbolBaseSP& base, vector<int>& ids) {
+	const OffsetType* offsets = (const OffsetType*)array->buffers[1] + array->offset;
+	const char* data = (const char*)array->buffers[2];
+	const unsigned char* validity = validityOf(array);
+	ids.resize(array->length);
+	for (int64_t i = 0; i < array->length; ++i) {
+		if (isValid(validity, array->offset + i))
+			ids[i] = base->findAndInsert(string(data + offsets[i], offsets[i + 1] - offsets[i]));
+		else
+			ids[i] = 0;
+	}
+}
+
+template <typename T>
+static bool mapCodes(const ArrowArray* array, const vector<int>& ids, int* out) {
+	const T* codes = (const T*)array->buffers[1] + array->offset;
+	const unsigned char* validity = validityOf(array);
+	bool containNull = false;
+	for (int64_t i = 0; i < array->length; ++i) {
+		if (!isValid(validity, array->offset + i)) {
+			out[i] = 0;
+		}
+		else {
+			size_t code = (size_t)codes[i];
+			if (code >= ids.size())
+				throw RuntimeException("Arrow dictionary index out of range.");
+			out[i] = ids[code];
+		}
+		containNull = containNull || out[i] == 0;
+	}
+	return containNull;
+}
+
+//Dictionary-encoded utf8 becomes a SYMBOL vector.
+static Vector* importDictionary(const ArrowSchema* schema, const ArrowArray* array) {
+	string valueFormat(schema->dictionary->format);
+	if ((valueFormat != "u" && valueFormat != "U") || array->dictionary == NULL)
+		throw RuntimeException("Cannot convert Arrow dictionary of type '" + valueFormat + "' to DolphinDB.");
+	SymbolBaseSP base = new SymbolBase(0);
+	base->findAndInsert("");
+	vector<int> ids;
+	if (valueFormat == "u")
+		decodeDictionary<int>(array->dictionary, base, ids);
+	else
+		decodeDictionary<long long>(array->dictionary, base, ids);
+
+	int length = (int)array->length;
+	int* buf = new int[length];
+	bool containNull;
+	try {
+		switch (schema->format[0]) {
+			case 'c': containNull = mapCodes<char>(array, ids, buf); break;
+			case 'C': containNull = mapCodes<unsigned char>(array, ids, buf); break;
+			case 's': containNull = mapCodes<short>(array, ids, buf); break;
+			case 'S': containNull = mapCodes<unsigned short>(array, ids, buf); break;
+			case 'i': containNull = mapCodes<int>(array, ids, buf); break;
+			case 'I': containNull = mapCodes<unsigned int>(array, ids, buf); break;
+			case 'l': containNull = mapCodes<long long>(array, ids, buf); break;
+			case 'L': containNull = mapCodes<unsigned long long>(array, ids, buf); break;
+			default:
+				throw RuntimeException("Invalid Arrow dictionary index type '" + string(schema->format) + "'.");
+		}
+	}
+	catch (...) {
+		delete[] buf;
+		throw;
+	}
+	return new FastSymbolVector(base, length, length, buf, containNull);
+}
+
+static VectorSP importVector(const ArrowSchema* schema, const ArrowArray* array, const ArrowArrayHolderSP& holder);
+
+//list<T> becomes an array vector. A null list becomes a row holding one null value, which is how
+//DolphinDB marks a null row of an array vector.
+template <typename OffsetType>
+static Vector* importList(const ArrowSchema* schema, const ArrowArray* array, const ArrowArrayHolderSP& holder) {
+	VectorSP values = importVector(schema->children[0], array->children[0], holder);
+	DATA_CATEGORY category = values->getCategory();
+	if (category == LITERAL || category == ARRAY || category == MIXED)
+		throw RuntimeException("Cannot convert Arrow list of " + Util::getDataTypeString(values->getType()) + " to DolphinDB array vector.");
+	int length = (int)array->length;
+	if (length == 0)
+		return Util::createArrayVector((DATA_TYPE)(values->getType() + ARRAY_TYPE_BASE), 0);
+	const OffsetType* offsets = (const OffsetType*)array->buffers[1] + array->offset;
+	long long first = offsets[0];
+	long long last = offsets[length];
+	if (last - first > INT_MAX)
+		throw RuntimeException("The Arrow list array is too long for a DolphinDB array vector.");
+	INDEX* index = new INDEX[length];
+	const unsigned char* validity = validityOf(array);
+	if (validity == NULL) {
+		for (int i = 0; i < length; ++i)
+			index[i] = (INDEX)(offsets[i + 1] - first);
+		if (first != 0 || last != values->size())
+			values = values->getSubVector(first, last - first);
+	}
+	else {
+		//the values of a null list, if any, are skipped
+		VectorSP rows = Util::createVector(values->getType(), 0, (INDEX)(last - first) + (INDEX)array->null_count);
+		ConstantSP null = Util::createNullConstant(values->getType());
+		for (int i = 0; i < length; ++i) {
+			if (isValid(validity, array->offset + i)) {
+				INDEX count = (INDEX)(offsets[i + 1] - offsets[i]);
+				if (count > 0 && !rows->append(values, (INDEX)offsets[i], count)) {
+					delete[] index;
+					throw RuntimeException("Failed to append the values of an Arrow list.");
+				}
+			}
+			else {
+				rows->append(null);
+			}
+			index[i] = rows->size();
+		}
+		rows->setNullFlag(true);
+		values = rows;
+	}
+	VectorSP indexVector = Util::createVector(DT_INT, length, length, true, 0, index);
+	return Util::createArrayVector(indexVector, values);
+}
+
+static VectorSP importVector(const ArrowSchema* schema, const ArrowArray* array, const ArrowArrayHolderSP& holder) {
+	if (array->length > INT_MAX)
+		throw RuntimeException("The Arrow array is too long for a DolphinDB vector.");
+	if (schema->dictionary != NULL)
+		return importDictionary(schema, array);
+
+	string format(schema->format);
+	switch (format[0]) {
+		case 'b': return importBool(array);
+		case 'c': return importFixedWidth<FastCharVector, char>(array, holder, CHAR_MIN);
+		case 's': return importFixedWidth<FastShortVector, short>(array, holder, SHRT_MIN);
+		case 'i': return importFixedWidth<FastIntVector, int>(array, holder, INT_MIN);
+		case 'l': return importFixedWidth<FastLongVector, long long>(array, holder, LLONG_MIN);
+		case 'f': return importFixedWidth<FastFloatVector, float>(array, holder, FLT_NMIN);
+		case 'g': return importFixedWidth<FastDoubleVector, double>(array, holder, DBL_NMIN);
+		//unsigned integers are widened to the next signed type, uint64 is reinterpreted as LONG
+		case 'C': return importConverted<FastShortVector, unsigned char, short>(array, SHRT_MIN, [](unsigned char v) { return (short)v; });
+		case 'S': return importConverted<FastIntVector, unsigned short, int>(array, INT_MIN, [](unsigned short v) { return (int)v; });
+		case 'I': return importConverted<FastLongVector, unsigned int, long long>(array, LLONG_MIN, [](unsigned int v) { return (long long)v; });
+		case 'L': return importConverted<FastLongVector, unsigned long long, long long>(array, LLONG_MIN, [](unsigned long long v) { return (long long)v; });
+		case 'u': return importStrings<int>(array, false);
+		case 'U': return importStrings<long long>(array, false);
+		case 'z': return importStrings<int>(array, true);
+		case 'Z': return importStrings<long long>(array, true);
+		case 'w':
+			if (format == "w:16")
+				return importInt128(schema, array);
+			break;
+		case 't':
+			//timestamps with a time zone are taken as UTC
+			if (format == "tdD")
+				return importFixedWidth<FastDateVector, int>(array, holder, INT_MIN);
+			if (format == "tdm")
+				return importConverted<FastDateVector, long long, int>(array, INT_MIN, [](long long v) { return (int)floorDivide(v, 86400000LL); });
+			if (format == "tts")
+				return importFixedWidth<FastSecondVector, int>(array, holder, INT_MIN);
+			if (format == "ttm")
+				return importFixedWidth<FastTimeVector, int>(array, holder, INT_MIN);
+			if (format == "ttu")
+				return importConverted<FastNanoTimeVector, long long, long long>(array, LLONG_MIN, [](long long v) { return v * 1000; });
+			if (format == "ttn")
+				return importFixedWidth<FastNanoTimeVector, long long>(array, holder, LLONG_MIN);
+			if (format.compare(0, 4, "tss:") == 0)
+				return importConverted<FastDateTimeVector, long long, int>(array, INT_MIN, [](long long v) { return (int)v; });
+			if (format.compare(0, 4, "tsm:") == 0)
+				return importFixedWidth<FastTimestampVector, long long>(array, holder, LLONG_MIN);
+			if (format.compare(0, 4, "tsu:") == 0)
+				return importConverted<FastNanoTimestampVector, long long, long long>(array, LLONG_MIN, [](long long v) { return v * 1000; });
+			if (format.compare(0, 4, "tsn:") == 0)
+				return importFixedWidth<FastNanoTimestampVector, long long>(array, holder, LLONG_MIN);
+			break;
+		case '+':
+			if (format == "+l")
+				return importList<int>(schema, array, holder);
+			if (format == "+L")
+				return importList<long long>(schema, array, holder);
+			break;
+		default:
+			break;
+	}
+	throw RuntimeException("Cannot convert Arrow type '" + format + "' to DolphinDB.");
+}
+
+static ConstantSP importTable(const ArrowSchema* schema, const ArrowArray* array, const ArrowArrayHolderSP& holder) {
+	vector<string> names;
+	vector<ConstantSP> cols;
+	for (int64_t i = 0; i < schema->n_children; ++i) {
+		VectorSP col = importVector(schema->children[i], array->children[i], holder);
+		if (array->offset != 0 || col->size() != array->length)
+			col = col->getSubVector(array->offset, array->length);
+		const char* name = schema->children[i]->name;
+		names.push_back(name != NULL && name[0] != 0 ? string(name) : "col" + std::to_string(i));
+		cols.push_back(col);
+	}
+	return Util::createTable(names, cols);
+}
+
+ConstantSP ArrowBridge::importArray(const ArrowSchema* schema, ArrowArray* array) {
+	if (array->release == NULL)
+		throw RuntimeException("The Arrow array has already been released.");
+	ArrowArrayHolderSP holder = new ArrowArrayHolder(array);
+	if (strcmp(schema->format, "+s") == 0)
+		return importTable(schema, holder->get(), holder);
+	return importVector(schema, holder->get(), holder);
+}
+
+//Zero-length arrays of a schema, for a stream without any batch.
+class EmptyArrayFactory {
+public:
+	ArrowArray* create(const ArrowSchema* schema) {
+		arrays_.emplace_back();
+		ArrowArray* array = &arrays_.back();
+		memset(array, 0, sizeof(ArrowArray));
+		array->n_buffers = 3;
+		array->buffers = buffers_;
+		if (schema->n_children > 0) {
+			children_.emplace_back();
+			vector<ArrowArray*>& children = children_.back();
+			for (int64_t i = 0; i < schema->n_children; ++i)
+				children.push_back(create(schema->children[i]));
+			array->n_children = schema->n_children;
+			array->children = children.data();
+		}
+		if (schema->dictionary != NULL)
+			array->dictionary = create(schema->dictionary);
+		return array;
+	}
+private:
+	std::deque<ArrowArray> arrays_;
+	std::deque<vector<ArrowArray*>> children_;
+	long long zeros_[2] = {0, 0};
+	const void* buffers_[3] = {NULL, zeros_, zeros_};
+};
+
+static VectorSP concatVectors(const vector<ConstantSP>& parts) {
+	INDEX total = 0;
+	for (const ConstantSP& part : parts)
+		total += part->size();
+	DATA_TYPE type = parts[0]->getType();
+	VectorSP result = type >= ARRAY_TYPE_BASE ? Util::createArrayVector(type, 0, total) : Util::createVector(type, 0, total);
+	for (const ConstantSP& part : parts) {
+		if (!result->append(part))
+			throw RuntimeException("Failed to concatenate the batches of an Arrow stream.");
+	}
+	return result;
+}
+
+ConstantSP ArrowBridge::importStream(ArrowArrayStream* stream) {
+	if (stream->release == NULL)
+		throw RuntimeException("The Arrow stream has already been released.");
+	struct StreamGuard {
+		ArrowArrayStream stream;
+		ArrowSchema schema;
+		~StreamGuard() {
+			if (schema.release != NULL)
+				schema.release(&schema);
+			stream.release(&stream);
+		}
+		string error(const string& what) {
+			const char* msg = stream.get_last_error(&stream);
+			return what + (msg != NULL ? ": " + string(msg) : string("."));
+		}
+	} guard;
+	guard.stream = *stream;
+	stream->release = NULL;
+	guard.schema.release = NULL;
+
+	if (guard.stream.get_schema(&guard.stream, &guard.schema) != 0)
+		throw RuntimeException(guard.error("Failed to get the schema of the Arrow stream"));
+	vector<ConstantSP> batches;
+	while (true) {
+		ArrowArray batch;
+		if (guard.stream.get_next(&guard.stream, &batch) != 0)
+			throw RuntimeException(guard.error("Failed to read the Arrow stream"));
+		if (batch.release == NULL)
+			break;
+		batches.push_back(importArray(&guard.schema, &batch));
+	}
+	if (batches.empty()) {
+		EmptyArrayFactory factory;
+		ArrowArray* empty = factory.create(&guard.schema);
+		if (strcmp(guard.schema.format, "+s") == 0)
+			return importTable(&guard.schema, empty, ArrowArrayHolderSP());
+		return importVector(&guard.schema, empty, ArrowArrayHolderSP());
+	}
+	if (batches.size() == 1)
+		return batches[0];
+	if (!batches[0]->isTable())
+		return concatVectors(batches);
+
+	TableSP first = batches[0];
+	vector<string> names;
+	vector<ConstantSP> cols;
+	for (INDEX i = 0; i < first->columns(); ++i) {
+		vector<ConstantSP> parts;
+		for (ConstantSP& batch : batches)
+			parts.push_back(batch->getColumn(i));
+		names.push_back(first->getColumnName(i));
+		cols.push_back(concatVectors(parts));
+	}
+	return Util::createTable(names, cols);
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * ArrowBridge.h
+ *
+ * Conversion between DolphinDB vectors/tables and the Arrow C Data Interface
+ * (https://arrow.apache.org/docs/format/CDataInterface.html). The structs are
+ * declared here, so neither the Arrow C++ library nor pyarrow is needed to build.
+ *
+ * Export: fixed-width columns share the vector's memory, the exported array keeps
+ * a reference to the vector until the consumer releases it. BOOL, MONTH, MINUTE,
+ * DATETIME and DATEHOUR have no Arrow type with the same layout and are copied.
+ * STRING/BLOB columns are written as offsets + data, SYMBOL as a dictionary of utf8.
+ *
+ * Import: arrays without nulls are borrowed; the DolphinDB vector keeps the Arrow
+ * array alive and releases it when the vector is destroyed. Arrays with nulls are
+ * copied so the null values can be written.
+ */
+
+#ifndef ARROWBRIDGE_H_
+#define ARROWBRIDGE_H_
+
+#include <stdint.h>
+
+#include "DolphinDB.h"
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+	void (*release)(struct ArrowSchema*);
+	void* private_data;
+};
+
+struct ArrowArray {
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+	void (*release)(struct ArrowArray*);
+	void* private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+	int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+	int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+	const char* (*get_last_error)(struct ArrowArrayStream*);
+	void (*release)(struct ArrowArrayStream*);
+	void* private_data;
+};
+
+#endif /* ARROW_C_STREAM_INTERFACE */
+
+namespace dolphindb {
+
+class ArrowBridge {
+public:
+	/**
+	 * Fill schema and array with the content of obj. A table becomes a struct array
+	 * (a record batch), a vector a plain array and a scalar an array of length 1.
+	 * Both outputs must be released by the caller with their release callbacks.
+	 */
+	static void exportConstant(const ConstantSP& obj, ArrowSchema* schema, ArrowArray* array);
+
+	/**
+	 * Create a DolphinDB object from an Arrow array. A struct array becomes a table.
+	 * The array is moved: array->release is set to NULL and the returned object owns it.
+	 * The schema is only read.
+	 */
+	static ConstantSP importArray(const ArrowSchema* schema, ArrowArray* array);
+
+	/**
+	 * Read all batches of the stream and concatenate them. The stream is released afterwards.
+	 */
+	static ConstantSP importStream(ArrowArrayStream* stream);
+};
+
+}
+
+#endif /* ARROWBRIDGE_H_ */
@@ -559,6 +559,181 @@ long long StringVector::getAllocatedMemory(INDEX size) const {
 	return bytes + sampleBytes / len * size;
 }
 
+PackedStringVector::PackedStringVector(vector<char>&& data, vector<long long>&& offsets, bool containNull, bool blob) :
+		data_(std::move(data)), offsets_(std::move(offsets)), blob_(blob){
+	if(offsets_.empty())
+		offsets_.push_back(0);
+	containNull_ = containNull;
+}
+
+ConstantSP PackedStringVector::get(const ConstantSP& index) const {
+	INDEX size = this->size();
+	if(!index->isVector()){
+		INDEX idx = index->getIndex();
+		return ConstantSP(new String(idx >= 0 && idx < size ? getString(idx) : "", blob_));
+	}
+
+	INDEX len = index->size();
+	StringVector* p = new StringVector(len, len, blob_);
+	ConstantSP result(p);
+	const int bufSize = Util::BUF_SIZE;
+	INDEX bufIndex[bufSize];
+	INDEX start = 0;
+	while(start < len){
+		int count = (std::min)(len - start, bufSize);
+		index->getIndex(start, count, bufIndex);
+		for(int i=0; i<count; ++i){
+			if(bufIndex[i] >= 0 && bufIndex[i] < size)
+				p->setString(start + i, getString(bufIndex[i]));
+		}
+		start += count;
+	}
+	p->setNullFlag(containNull_ || p->hasNull());
+	return result;
+}
+
+ConstantSP PackedStringVector::getSubVector(INDEX start, INDEX length, INDEX capacity) const {
+	StringVector* vec = new StringVector(0, capacity, blob_);
+	ConstantSP result(vec);
+	if(start<0 || start>=size() || std::abs(length)>size())
+		return result;
+
+	INDEX step = length > 0 ? 1 : -1;
+	for(INDEX i=0, cur=start; i<std::abs(length); ++i, cur+=step){
+		string str = getString(cur);
+		vec->appendString(&str, 1);
+	}
+	result->setNullFlag(containNull_);
+	return result;
+}
+
+ConstantSP PackedStringVector::getValue(INDEX capacity) const {
+	INDEX size = this->size();
+	ConstantSP copy = size > 0 ? getSubVector(0, size, (std::max)(size, capacity)) : ConstantSP(new StringVector(0, capacity, blob_));
+	copy->setForm(getForm());
+	return copy;
+}
+
+bool PackedStringVector::hasNull(INDEX start, INDEX length){
+	for(INDEX i=start; i<start+length; ++i){
+		if(this->length(i) == 0)
+			return true;
+	}
+	return false;
+}
+
+bool PackedStringVector::isNull(INDEX start, int len, char* buf) const {
+	for(int i=0;i<len;++i)
+		buf[i] = length(start + i) == 0;
+	return true;
+}
+
+bool PackedStringVector::append(const ConstantSP& value, INDEX len){
+	if(value->isScalar()){
+		string str = value->getString();
+		for(INDEX i=0; i<len; ++i)
+			appendRaw(str.data(), str.size());
+	}
+	else if(value->getCategory()==LITERAL && !blob_){
+		char* bufVal[Util::BUF_SIZE];
+		INDEX start=0;
+		while(start<len){
+			int count=((std::min))(len-start,Util::BUF_SIZE);
+			appendString(value->getStringConst(start,count,bufVal), count);
+			start+=count;
+		}
+	}
+	else{
+		for(INDEX i=0;i<len;i++){
+			string str = value->getString(i);
+			appendRaw(str.data(), str.size());
+		}
+	}
+	if(value->getNullFlag())
+		containNull_=true;
+	return true;
+}
+
+bool PackedStringVector::appendString(string* buf, int len){
+	for(int i=0;i<len;i++)
+		appendRaw(buf[i].data(), buf[i].size());
+	return true;
+}
+
+bool PackedStringVector::appendString(char** buf, int len){
+	for(int i=0;i<len;i++)
+		appendRaw(buf[i], strlen(buf[i]));
+	return true;
+}
+
+bool PackedStringVector::remove(INDEX count){
+	bool fromHead=(count<0);
+	count=((std::min))(size(),abs(count));
+	if(fromHead){
+		long long shift = offsets_[count];
+		data_.erase(data_.begin(), data_.begin() + shift);
+		offsets_.erase(offsets_.begin(), offsets_.begin() + count);
+		for(long long& offset : offsets_)
+			offset -= shift;
+	}
+	else{
+		offsets_.resize(offsets_.size() - count);
+		data_.resize(offsets_.back());
+	}
+	return true;
+}
+
+int PackedStringVector::serialize(char* buf, int bufSize, INDEX indexStart, int offset, int& numElement, int& partial) const {
+	INDEX size = this->size();
+	if(indexStart >= size)
+		return -1;
+
+	if(!blob_){
+		//The buffer already holds the wire format: copy as many bytes as fit and count the strings completed.
+		long long begin = offsets_[indexStart] + offset;
+		long long end = (std::min)(begin + bufSize, offsets_[size]);
+		INDEX last = std::upper_bound(offsets_.begin() + indexStart + 1, offsets_.end(), end) - offsets_.begin() - 1;
+		memcpy(buf, data_.data() + begin, end - begin);
+		numElement = last - indexStart;
+		partial = last < size ? (int)(end - offsets_[last]) : 0;
+		return (int)(end - begin);
+	}
+
+	const int lenBytes = sizeof(int);
+	int initialBufSize = bufSize;
+	INDEX initialIndex = indexStart;
+	partial = 0;
+	while(bufSize > 0 && indexStart < size){
+		const char* str = data_.data() + offsets_[indexStart];
+		int len = length(indexStart);
+		if(LIKELY(offset == 0)){
+			if(UNLIKELY(bufSize < lenBytes))
+				break;
+			memcpy(buf, &len, lenBytes);
+			buf += lenBytes;
+			bufSize -= lenBytes;
+		}
+		else{
+			offset -= lenBytes;
+		}
+
+		if(bufSize >= len - offset){
+			memcpy(buf, str + offset, len - offset);
+			buf += len - offset;
+			bufSize -= len - offset;
+			++indexStart;
+			offset = 0;
+		}
+		else{
+			memcpy(buf, str + offset, bufSize);
+			partial = lenBytes + offset + bufSize;
+			bufSize = 0;
+		}
+	}
+	numElement = indexStart - initialIndex;
+	return initialBufSize - bufSize;
+}
+
 void AnyVector::clear(){
 	data_.clear();
 	containNull_ = false;
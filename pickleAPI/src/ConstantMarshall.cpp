@@ -124,6 +124,16 @@ bool VectorMarshall::writeMetaValues(BufferWriter<DataOutputStreamSP> &output, c
 		vec = target->getValue();
 
 	INDEX actualSize = 0;
+	if (blocking && size > 0 && vec->getType() != DT_ANY && vec->getType() != DT_SYMBOL && vec->getVectorType() == VECTOR_TYPE::ARRAY
+			&& vec->isFastMode() && vec->getDataArray() != NULL && (size_t)size * vec->getUnitLength() > MARSHALL_BUFFER_SIZE) {
+		//a large fixed-width vector is sent straight from its own memory behind the header instead of in 4K copies
+		IoSlice slices[2] = {{buf_, offset}, {(const char*)vec->getDataArray(), (size_t)size * vec->getUnitLength()}};
+		ret = output.getDataOutputStream()->write(slices, 2);
+		complete_ = (ret == OK);
+		if (complete_)
+			nextStart_ = size;
+		return complete_;
+	}
 	if (size>0 && vec->getType() != DT_ANY && vec->getType() != DT_SYMBOL) {
 		actualSize = vec->serialize(buf_ + offset, MARSHALL_BUFFER_SIZE - offset, 0, 0, numElement, partial_);
 		if (actualSize < 0) {
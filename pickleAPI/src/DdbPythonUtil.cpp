@@ -7,6 +7,11 @@
 #include "Util.h"
 #include "Pickle.h"
 #include "MultithreadedTableWriter.h"
+#include "NullKernel.h"
+#include "ArrowBridge.h"
+
+#include <list>
+#include <memory>
 
 namespace dolphindb {
 
@@ -70,12 +75,336 @@ py::object getPythonType(const py::object &obj){
     return Preserved::pynone_;
 }
 
-void DdbPythonUtil::createPyVector(const ConstantSP &obj,py::object &pyObject,bool tableFlag,const ToPythonOption *poption){
+// Hand the buffer of a fast vector to numpy without copying. The array's base is a capsule
+// holding a reference to the vector, so the buffer is freed when the last array using it dies.
+static bool wrapFastVector(const VectorSP &ddbVec, const char *dtype, py::object &pyObject) {
+    if (!ddbVec->isFastMode() || ddbVec->getDataArray() == NULL)
+        return false;
+    py::capsule base(new ConstantSP(ddbVec), [](void *p) { delete (ConstantSP *)p; });
+    py::dtype dt(dtype);
+    size_t size = ddbVec->size();
+    pyObject = py::array(dt, {size}, {(size_t)dt.itemsize()}, ddbVec->getDataArray(), base);
+    return true;
+}
+
+//Threads converting table columns while the GIL is released, for uploads and downloads. A task reads a buffer
+//whose owner the caller keeps alive and writes into a buffer of its own column, it never touches a Python object.
+class ColumnConvertPool {
+    struct Batch;
+public:
+    typedef std::function<void()> Task;
+    typedef SmartPointer<Batch> BatchSP;
+
+    //Run all tasks and return once they are done. The calling thread executes tasks too.
+    static void run(vector<Task> &tasks, bool parallel) {
+        if (tasks.empty())
+            return;
+        BatchSP batch = new Batch(tasks);
+        if (parallel && tasks.size() > 1)
+            instance().share(batch, tasks.size() - 1);
+        wait(batch);
+    }
+
+    //Hand the tasks to the workers and return at once. The batch keeps its own copy of the tasks,
+    //so it outlives the caller if need be.
+    static BatchSP submit(const vector<Task> &tasks) {
+        if (tasks.empty())
+            return BatchSP();
+        BatchSP batch = new Batch(vector<Task>(tasks));
+        instance().share(batch, tasks.size());
+        return batch;
+    }
+
+    //Run what is left of a submitted batch on the calling thread too and return once all its tasks are done.
+    static void wait(const BatchSP &batch) {
+        if (batch.isNull())
+            return;
+        batch->work();
+        batch->latch_.wait();
+        if (!batch->error_.empty())
+            throw RuntimeException(batch->error_);
+    }
+
+private:
+    struct Batch {
+        Batch(vector<Task> &tasks) : tasks_(tasks), count_(tasks.size()), next_(0), latch_(tasks.size()) {}
+        Batch(vector<Task> &&tasks) : owned_(std::move(tasks)), tasks_(owned_), count_(owned_.size()), next_(0), latch_(owned_.size()) {}
+        void work() {
+            //a worker may pick the batch up after the caller returned, so check count_ before tasks_
+            size_t index;
+            while ((index = next_++) < count_) {
+                try {
+                    tasks_[index]();
+                } catch (std::exception &ex) {
+                    LockGuard<Mutex> guard(&mutex_);
+                    if (error_.empty())
+                        error_ = ex.what();
+                }
+                latch_.countDown();
+            }
+        }
+        vector<Task> owned_;
+        vector<Task> &tasks_;
+        size_t count_;
+        std::atomic<size_t> next_;
+        CountDownLatch latch_;
+        Mutex mutex_;
+        std::string error_;
+    };
+
+    class Worker : public Runnable {
+    public:
+        Worker(SynchronizedQueue<SmartPointer<Batch>> &queue) : queue_(queue) {}
+    protected:
+        virtual void run() {
+            SmartPointer<Batch> batch;
+            while (true) {
+                queue_.blockingPop(batch);
+                batch->work();
+                batch.clear();
+            }
+        }
+    private:
+        SynchronizedQueue<SmartPointer<Batch>> &queue_;
+    };
+
+    ColumnConvertPool() {
+        int count = std::max(1, Util::getCoreCount() - 1);
+        for (int i = 0; i < count; ++i) {
+            ThreadSP thread = new Thread(new Worker(queue_));
+            thread->start();
+            workers_.push_back(thread);
+        }
+    }
+
+    void share(const BatchSP &batch, size_t helpers) {
+        helpers = std::min(helpers, workers_.size());
+        for (size_t i = 0; i < helpers; ++i)
+            queue_.push(batch);
+    }
+
+    static ColumnConvertPool &instance() {
+        //never destroyed, the workers live as long as the process
+        static ColumnConvertPool *pool = new ColumnConvertPool();
+        return *pool;
+    }
+
+    SynchronizedQueue<SmartPointer<Batch>> queue_;
+    vector<ThreadSP> workers_;
+};
+
+//Run a fill right away, or queue it when a table is converted and the fills run with the GIL released.
+static void fillNowOrLater(vector<ColumnConvertPool::Task> *deferred, ColumnConvertPool::Task task) {
+    if (deferred != NULL)
+        deferred->push_back(std::move(task));
+    else
+        task();
+}
+
+// Integer column with nulls to float64: one pass from the vector's buffer straight into the result.
+// getXxxConst returns the vector's own data for fast vectors, buf is only used for other vector kinds.
+template <typename T>
+static void fillFloat64WithNull(Vector *ddbVec, size_t size, T nullValue, const T* (Constant::*getConst)(INDEX, int, T*) const, double *p) {
+    T buf[1024];
+    size_t start = 0;
+    while (start < size) {
+        int len = std::min(size - start, (size_t)1024);
+        const T *data = (ddbVec->*getConst)(start, len, buf);
+        for (int i = 0; i < len; ++i) {
+            if (UNLIKELY(data[i] == nullValue))
+                SET_NPNAN(p + start + i, 1);
+            else
+                p[start + i] = data[i];
+        }
+        start += len;
+    }
+}
+
+template <typename T>
+static py::array toFloat64WithNull(Vector *ddbVec, size_t size, T nullValue, const T* (Constant::*getConst)(INDEX, int, T*) const,
+                                   vector<ColumnConvertPool::Task> *deferred) {
+    py::array pyVec(py::dtype("float64"), {size}, {});
+    double *p = (double *)pyVec.mutable_data();
+    fillNowOrLater(deferred, [=]() { fillFloat64WithNull<T>(ddbVec, size, nullValue, getConst, p); });
+    return pyVec;
+}
+
+// FLOAT/DOUBLE with nulls: copy and replace the DolphinDB null with NaN in the same pass.
+template <typename T>
+static py::array toFloatingWithNull(Vector *ddbVec, size_t size, const char *dtype, T nullValue,
+                                    const T* (Constant::*getConst)(INDEX, int, T*) const, vector<ColumnConvertPool::Task> *deferred) {
+    py::array pyVec(py::dtype(dtype), {size}, {});
+    T *p = (T *)pyVec.mutable_data();
+    fillNowOrLater(deferred, [=]() {
+        T buf[1024];
+        size_t start = 0;
+        while (start < size) {
+            int len = std::min(size - start, (size_t)1024);
+            const T *data = (ddbVec->*getConst)(start, len, buf);
+            for (int i = 0; i < len; ++i)
+                p[start + i] = UNLIKELY(data[i] == nullValue) ? (T)NAN : data[i];
+            start += len;
+        }
+    });
+    return pyVec;
+}
+
+// values + mask for pandas masked arrays, masked values are 0.
+template <typename T>
+static void fillValuesAndMask(Vector *ddbVec, size_t size, T nullValue, const T* (Constant::*getConst)(INDEX, int, T*) const,
+                              T *values, bool *mask) {
+    T buf[1024];
+    size_t start = 0;
+    while (start < size) {
+        int len = std::min(size - start, (size_t)1024);
+        const T *data = (ddbVec->*getConst)(start, len, buf);
+        for (int i = 0; i < len; ++i) {
+            bool isNull = data[i] == nullValue;
+            mask[start + i] = isNull;
+            values[start + i] = isNull ? 0 : data[i];
+        }
+        start += len;
+    }
+}
+
+template <typename T>
+static py::object createMaskedArray(const py::object &arrayClass, const char *dtype, Vector *ddbVec, size_t size, T nullValue,
+                                    const T* (Constant::*getConst)(INDEX, int, T*) const, vector<ColumnConvertPool::Task> *deferred) {
+    using namespace py::literals;
+    py::array values(py::dtype(dtype), {size}, {});
+    py::array mask(py::dtype("bool"), {size}, {});
+    T *pvalues = (T *)values.mutable_data();
+    bool *pmask = (bool *)mask.mutable_data();
+    fillNowOrLater(deferred, [=]() { fillValuesAndMask<T>(ddbVec, size, nullValue, getConst, pvalues, pmask); });
+    //copy=False: the array keeps using both buffers, so they may still be filled afterwards
+    return arrayClass(values, mask, "copy"_a = false);
+}
+
+static py::object pandasArrayClass(const char *name) {
+    return Preserved::pandas_.attr("arrays").attr(name);
+}
+
+// pandas.arrays.IntegerArray/BooleanArray wrapping the two numpy arrays without copying.
+static py::object createMaskedArray(Vector *ddbVec, size_t size, vector<ColumnConvertPool::Task> *deferred) {
+    static PyObject *integerArray = pandasArrayClass("IntegerArray").release().ptr();
+    static PyObject *booleanArray = pandasArrayClass("BooleanArray").release().ptr();
+    py::object integers = py::reinterpret_borrow<py::object>(integerArray);
+    switch (ddbVec->getType()) {
+        case DT_BOOL:
+            return createMaskedArray<char>(py::reinterpret_borrow<py::object>(booleanArray), "bool", ddbVec, size, CHAR_MIN, &Constant::getBoolConst, deferred);
+        case DT_CHAR:
+            return createMaskedArray<char>(integers, "int8", ddbVec, size, CHAR_MIN, &Constant::getCharConst, deferred);
+        case DT_SHORT:
+            return createMaskedArray<short>(integers, "int16", ddbVec, size, SHRT_MIN, &Constant::getShortConst, deferred);
+        case DT_INT:
+            return createMaskedArray<int>(integers, "int32", ddbVec, size, INT_MIN, &Constant::getIntConst, deferred);
+        case DT_LONG:
+            return createMaskedArray<long long>(integers, "int64", ddbVec, size, LLONG_MIN, &Constant::getLongConst, deferred);
+        default:
+            throw RuntimeException("Type " + Util::getDataTypeString(ddbVec->getType()) + " has no pandas nullable dtype.");
+    }
+}
+
+// Temporal vector to datetime64 in one pass over the source: out = (value - offset) * unit, null becomes NaT.
+template <typename T>
+static py::array toDatetime64(Vector *ddbVec, size_t size, const char *dtype, T nullValue, const T* (Constant::*getConst)(INDEX, int, T*) const,
+                              long long offset, long long unit, vector<ColumnConvertPool::Task> *deferred) {
+    py::array pyVec(py::dtype(dtype), {size}, {});
+    long long *p = (long long *)pyVec.mutable_data();
+    fillNowOrLater(deferred, [=]() {
+        T buf[1024];
+        size_t start = 0;
+        while (start < size) {
+            int len = std::min(size - start, (size_t)1024);
+            const T *data = (ddbVec->*getConst)(start, len, buf);
+            for (int i = 0; i < len; ++i)
+                p[start + i] = UNLIKELY(data[i] == nullValue) ? npLongNan_ : (data[i] - offset) * unit;
+            start += len;
+        }
+    });
+    return pyVec;
+}
+
+// MONTH (year * 12 + month - 1) to datetime64[ns]. Months have no fixed length in ns, so the first day of
+// each month is looked up; a column usually spans few months, the last one is cached.
+static void fillMonthDatetime64ns(Vector *ddbVec, size_t size, long long *p) {
+    int buf[1024];
+    int lastMonth = INT_MIN;
+    long long lastValue = 0;
+    size_t start = 0;
+    while (start < size) {
+        int len = std::min(size - start, (size_t)1024);
+        const int *data = ddbVec->getIntConst(start, len, buf);
+        for (int i = 0; i < len; ++i) {
+            int month = data[i];
+            if (UNLIKELY(month == INT_MIN)) {
+                p[start + i] = npLongNan_;
+                continue;
+            }
+            if (month != lastMonth) {
+                // datetime64[ns] covers 1677.09.21 to 2262.04.11
+                if (month < 1677 * 12 + 9 || month > 2262 * 12 + 3)
+                    throw RuntimeException("In dataFrame Month must between 1677.10M and 2262.04M");
+                lastMonth = month;
+                lastValue = Util::countDays(month / 12, month % 12 + 1, 1) * 86400000000000ll;
+            }
+            p[start + i] = lastValue;
+        }
+        start += len;
+    }
+}
+
+static py::array monthToDatetime64ns(Vector *ddbVec, size_t size, vector<ColumnConvertPool::Task> *deferred) {
+    py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
+    long long *p = (long long *)pyVec.mutable_data();
+    fillNowOrLater(deferred, [=]() { fillMonthDatetime64ns(ddbVec, size, p); });
+    return pyVec;
+}
+
+// SYMBOL vector with its symbol base: each distinct string is converted once and every row refers to
+// the same str object. As a Categorical the ids are used as codes directly, id 0 (the empty string) is null.
+static py::object createPySymbols(const VectorSP &ddbVec, bool asCategory) {
+    SymbolBaseSP base = ddbVec->getSymbolBase();
+    const int *ids = (const int *)ddbVec->getDataArray();
+    size_t size = ddbVec->size();
+    int count = base->size();
+    if (asCategory) {
+        using namespace py::literals;
+        py::list categories(count > 0 ? count - 1 : 0);
+        for (int i = 1; i < count; ++i)
+            categories[i - 1] = py::str(base->getSymbol(i));
+        py::array codes(py::dtype("int32"), {size}, {});
+        int *p = (int *)codes.mutable_data();
+        for (size_t i = 0; i < size; ++i)
+            p[i] = ids[i] - 1;
+        return Preserved::pandas_.attr("Categorical").attr("from_codes")(codes, "categories"_a = categories);
+    }
+    vector<py::object> strs(count);
+    for (int i = 0; i < count; ++i)
+        strs[i] = py::str(base->getSymbol(i));
+    py::array pyVec(py::dtype("object"), {size}, {});
+    PyObject **p = (PyObject **)pyVec.mutable_data();
+    for (size_t i = 0; i < size; ++i) {
+        if (UNLIKELY(ids[i] < 0 || ids[i] >= count))
+            throw RuntimeException("Invalid symbol id " + std::to_string(ids[i]) + " in symbol vector.");
+        p[i] = strs[ids[i]].inc_ref().ptr();
+    }
+    return std::move(pyVec);
+}
+
+//Fills that only read the DolphinDB vector go to deferred if it is not NULL, see toPython for tables.
+static void convertPyVector(const ConstantSP &obj, py::object &pyObject, bool tableFlag, const DdbPythonUtil::ToPythonOption *poption,
+                            vector<ColumnConvertPool::Task> *deferred) {
     //RECORDTIME("createPyVector");
     VectorSP ddbVec = obj;
     size_t size = ddbVec->size();
     DATA_TYPE type = obj->getType();
     //DLOG("toPython vector",Util::getDataTypeString(type).data(),size,tableFlag);
+    if (poption != NULL && poption->nullableDtype &&
+            (type == DT_BOOL || type == DT_CHAR || type == DT_SHORT || type == DT_INT || type == DT_LONG)) {
+        pyObject = createMaskedArray(ddbVec.get(), size, deferred);
+        return;
+    }
     switch (type) {
         case DT_VOID: {
             py::array pyVec(py::dtype("object"));
@@ -84,6 +413,8 @@ void DdbPythonUtil::createPyVector(const ConstantSP &obj,py::object &pyObject,bo
             break;
         }
         case DT_BOOL: {
+            if (!ddbVec->hasNull() && wrapFastVector(ddbVec, "bool", pyObject))
+                break;
             py::array pyVec(py::dtype("bool"), {size}, {});
             ddbVec->getBool(0, size, (char *)pyVec.mutable_data());
             if (UNLIKELY(ddbVec->hasNull())) {
@@ -91,6 +422,7 @@ void DdbPythonUtil::createPyVector(const ConstantSP &obj,py::object &pyObject,bo
                 DLOG("has null.");
                 pyVec = pyVec.attr("astype")("object");
                 PyObject **p = (PyObject **)pyVec.mutable_data();
+                py::object nan = Preserved::numpy_.attr("nan");
                 char buf[1024];
                 int start = 0;
                 int N = size;
@@ -100,7 +432,7 @@ void DdbPythonUtil::createPyVector(const ConstantSP &obj,py::object &pyObject,bo
                     for (int i = 0; i < len; ++i) {
                         if(UNLIKELY(buf[i] == INT8_MIN)) {
                             Py_DECREF(p[start + i]);
-                            p[start + i] = Preserved::numpy_.attr("nan").ptr();
+                            p[start + i] = nan.inc_ref().ptr();
                         }
                     }
                     start += len;
@@ -110,395 +442,155 @@ void DdbPythonUtil::createPyVector(const ConstantSP &obj,py::object &pyObject,bo
             break;
         }
         case DT_CHAR: {
-            py::array pyVec(py::dtype("int8"), {size}, {});
-            ddbVec->getChar(0, size, (char *)pyVec.mutable_data());
             if (UNLIKELY(ddbVec->hasNull())) {
-                DLOG("has null.");
-                pyVec = pyVec.attr("astype")("float64");
-                double *p = (double *)pyVec.mutable_data();
-                char buf[1024];
-                int start = 0;
-                int N = size;
-                while (start < N) {
-                    int len = std::min(N - start, 1024);
-                    ddbVec->getChar(start, len, buf);
-                    for (int i = 0; i < len; ++i) {
-                        if(UNLIKELY(buf[i] == INT8_MIN)) {
-                            SET_NPNAN(p + start + i, 1);
-                        }
-                    }
-                    start += len;
-                }
+                pyObject = toFloat64WithNull<char>(ddbVec.get(), size, CHAR_MIN, &Constant::getCharConst, deferred);
+                break;
             }
+            if (wrapFastVector(ddbVec, "int8", pyObject))
+                break;
+            py::array pyVec(py::dtype("int8"), {size}, {});
+            ddbVec->getChar(0, size, (char *)pyVec.mutable_data());
             pyObject=std::move(pyVec);
             break;
         }
         case DT_SHORT: {
-            py::array pyVec(py::dtype("int16"), {size}, {});
-            ddbVec->getShort(0, size, (short *)pyVec.mutable_data());
             if (UNLIKELY(ddbVec->hasNull())) {
-                DLOG("has null.");
-                pyVec = pyVec.attr("astype")("float64");
-                double *p = (double *)pyVec.mutable_data();
-                short buf[1024];
-                int start = 0;
-                int N = size;
-                while (start < N) {
-                    int len = std::min(N - start, 1024);
-                    ddbVec->getShort(start, len, buf);
-                    for (int i = 0; i < len; ++i) {
-                        if(UNLIKELY(buf[i] == INT16_MIN)) {
-                            SET_NPNAN(p + start + i, 1);
-                        }
-                    }
-                    start += len;
-                }
+                pyObject = toFloat64WithNull<short>(ddbVec.get(), size, SHRT_MIN, &Constant::getShortConst, deferred);
+                break;
             }
+            if (wrapFastVector(ddbVec, "int16", pyObject))
+                break;
+            py::array pyVec(py::dtype("int16"), {size}, {});
+            ddbVec->getShort(0, size, (short *)pyVec.mutable_data());
             pyObject=std::move(pyVec);
             break;
         }
         case DT_INT: {
-            py::array pyVec(py::dtype("int32"), {size}, {});
-            ddbVec->getInt(0, size, (int *)pyVec.mutable_data());
             if (UNLIKELY(ddbVec->hasNull())) {
-                DLOG("has null.");
-                pyVec = pyVec.attr("astype")("float64");
-                double *p = (double *)pyVec.mutable_data();
-                int buf[1024];
-                int start = 0;
-                int N = size;
-                while (start < N) {
-                    int len = std::min(N - start, 1024);
-                    ddbVec->getInt(start, len, buf);
-                    for (int i = 0; i < len; ++i) {
-                        if(UNLIKELY(buf[i] == INT32_MIN)) {
-                            DLOG("set %d null.", i);
-                            SET_NPNAN(p + start + i, 1);
-                        }
-                    }
-                    start += len;
-                }
+                pyObject = toFloat64WithNull<int>(ddbVec.get(), size, INT_MIN, &Constant::getIntConst, deferred);
+                break;
             }
+            if (wrapFastVector(ddbVec, "int32", pyObject))
+                break;
+            py::array pyVec(py::dtype("int32"), {size}, {});
+            ddbVec->getInt(0, size, (int *)pyVec.mutable_data());
             pyObject=std::move(pyVec);
             break;
         }
         case DT_LONG: {
-            py::array pyVec(py::dtype("int64"), {size}, {});
-            ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
             if (UNLIKELY(ddbVec->hasNull())) {
-                DLOG("has null.");
-                pyVec = pyVec.attr("astype")("float64");
-                double *p = (double *)pyVec.mutable_data();
-                long long buf[1024];
-                int start = 0;
-                int N = size;
-                while (start < N) {
-                    int len = std::min(N - start, 1024);
-                    ddbVec->getLong(start, len, buf);
-                    for (int i = 0; i < len; ++i) {
-                        if(UNLIKELY(buf[i] == INT64_MIN)) {
-                            SET_NPNAN(p + start + i, 1);
-                        }
-                    }
-                    start += len;
-                }
+                pyObject = toFloat64WithNull<long long>(ddbVec.get(), size, LLONG_MIN, &Constant::getLongConst, deferred);
+                break;
             }
+            if (wrapFastVector(ddbVec, "int64", pyObject))
+                break;
+            py::array pyVec(py::dtype("int64"), {size}, {});
+            ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
             pyObject=std::move(pyVec);
             break;
         }
         case DT_DATE: {
-            if(tableFlag) {
-                py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                if (UNLIKELY(ddbVec->hasNull())) {
-                    DLOG("has null.");
-                    for (size_t i = 0; i < size; ++i) {
-                        if (UNLIKELY(p[i] == INT64_MIN)){
-                            SET_NPNAN(p + i,1);
-                        }else{
-                            p[i] *= 86400000000000;
-                        }
-                    }
-                }
-                else {
-                    for (size_t i = 0; i < size; ++i) {
-                        p[i] *= 86400000000000;
-                    }
-                }
-                pyObject=std::move(pyVec);
-            }else{
-                py::array pyVec(py::dtype("datetime64[D]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                pyObject=std::move(pyVec);
-            }
+            if (tableFlag)
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[ns]", INT_MIN, &Constant::getIntConst, 0, 86400000000000ll, deferred);
+            else
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[D]", INT_MIN, &Constant::getIntConst, 0, 1, deferred);
             break;
         }
         case DT_MONTH: {
-            if(tableFlag) {
-                py::array pyVec(py::dtype("datetime64[M]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                for (size_t i = 0; i < size; ++i) {
-                    if (UNLIKELY(p[i] == INT64_MIN)) {
-                        SET_NPNAN(p + i,1);
-                        continue;
-                    }
-                    if(p[i] < 1970 * 12 || p[i] > 2262 * 12 + 3) {
-                        throw RuntimeException("In dateFrame Month must between 1970.01M and 2262.04M");
-                    }
-                    p[i] -= 1970 * 12;
-                }
-                pyObject=std::move(pyVec);
-            }else{
-                py::array pyVec(py::dtype("datetime64[M]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                for (size_t i = 0; i < size; ++i) {
-                    if (UNLIKELY(p[i] == INT64_MIN)) {
-                        SET_NPNAN(p + i,1);
-                        continue;
-                    }
-                    p[i] -= 1970 * 12;
-                }
-                pyObject=std::move(pyVec);
-            }
+            if (tableFlag)
+                pyObject = monthToDatetime64ns(ddbVec.get(), size, deferred);
+            else
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[M]", INT_MIN, &Constant::getIntConst, 1970 * 12, 1, deferred);
             break;
         }
         case DT_TIME: {
-            if(tableFlag) {
-                py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                if (UNLIKELY(ddbVec->hasNull())) {
-                    DLOG("has null.");
-                    for (size_t i = 0; i < size; ++i) {
-                        if (UNLIKELY(p[i] == INT64_MIN)) {
-                            SET_NPNAN(p + i,1);
-                            continue;
-                        }
-                        p[i] *= 1000000;
-                    }
-                }
-                else {
-                    for (size_t i = 0; i < size; ++i) {
-                        p[i] *= 1000000;
-                    }
-                }
-                pyObject=std::move(pyVec);
-            }
-            else{
-                py::array pyVec(py::dtype("datetime64[ms]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                pyObject=std::move(pyVec);
-            }
+            if (tableFlag)
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[ns]", INT_MIN, &Constant::getIntConst, 0, 1000000, deferred);
+            else
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[ms]", INT_MIN, &Constant::getIntConst, 0, 1, deferred);
             break;
         }
         case DT_MINUTE: {
-            if(tableFlag) {
-                py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                if (UNLIKELY(ddbVec->hasNull())) {
-                    DLOG("has null.");
-                    for (size_t i = 0; i < size; ++i) {
-                        if (UNLIKELY(p[i] == INT64_MIN)) {
-                            SET_NPNAN(p + i,1);
-                            continue;
-                        }
-                        p[i] *= 60000000000;
-                    }
-                }
-                else {
-                    for (size_t i = 0; i < size; ++i) {
-                        p[i] *= 60000000000;
-                    }
-                }
-                pyObject=std::move(pyVec);
-            }else{
-                py::array pyVec(py::dtype("datetime64[m]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                //DLOG(".datetime64[m] array.");
-                pyObject=std::move(pyVec);
-            }
-            break;
-        }
-        case DT_SECOND: {
-            if(tableFlag) {
-                py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                if (UNLIKELY(ddbVec->hasNull())) {
-                    DLOG("has null.");
-                    for (size_t i = 0; i < size; ++i) {
-                        if (UNLIKELY(p[i] == INT64_MIN)) {
-                            SET_NPNAN(p + i,1);
-                            continue;
-                        }
-                        p[i] *= 1000000000;
-                    }
-                }
-                else {
-                    for (size_t i = 0; i < size; ++i) {
-                        p[i] *= 1000000000;
-                    }
-                }
-                pyObject=std::move(pyVec);
-            }
-            else{
-                py::array pyVec(py::dtype("datetime64[s]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                pyObject=std::move(pyVec);
-            }
+            if (tableFlag)
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[ns]", INT_MIN, &Constant::getIntConst, 0, 60000000000ll, deferred);
+            else
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[m]", INT_MIN, &Constant::getIntConst, 0, 1, deferred);
             break;
         }
+        case DT_SECOND:
         case DT_DATETIME: {
-            if(tableFlag) {
-                py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                if (UNLIKELY(ddbVec->hasNull())) {
-                    DLOG("has null.");
-                    for (size_t i = 0; i < size; ++i) {
-                        if (UNLIKELY(p[i] == INT64_MIN)) {
-                            SET_NPNAN(p + i,1);
-                            continue;
-                        }
-                        p[i] *= 1000000000;
-                    }
-                }
-                else {
-                    for (size_t i = 0; i < size; ++i) {
-                        p[i] *= 1000000000;
-                    }
-                }
-                pyObject=std::move(pyVec);
-            }else{
-                py::array pyVec(py::dtype("datetime64[s]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                pyObject=std::move(pyVec);
-            }
+            if (tableFlag)
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[ns]", INT_MIN, &Constant::getIntConst, 0, 1000000000, deferred);
+            else
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[s]", INT_MIN, &Constant::getIntConst, 0, 1, deferred);
             break;
         }
         case DT_TIMESTAMP: {
-            if(tableFlag) {
-                py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                if (UNLIKELY(ddbVec->hasNull())) {
-                    DLOG("has null.");
-                    for (size_t i = 0; i < size; ++i) {
-                        if (UNLIKELY(p[i] == INT64_MIN)) {
-                            SET_NPNAN(p + i,1);
-                            continue;
-                        }
-                        p[i] *= 1000000;
-                    }
-                }
-                else {
-                    for (size_t i = 0; i < size; ++i) {
-                        p[i] *= 1000000;
-                    }
-                }
-                pyObject=std::move(pyVec);
-            }else{
-                py::array pyVec(py::dtype("datetime64[ms]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                pyObject=std::move(pyVec);
+            if (tableFlag) {
+                pyObject = toDatetime64<long long>(ddbVec.get(), size, "datetime64[ns]", LLONG_MIN, &Constant::getLongConst, 0, 1000000, deferred);
+                break;
             }
+            if (wrapFastVector(ddbVec, "datetime64[ms]", pyObject))
+                break;
+            pyObject = toDatetime64<long long>(ddbVec.get(), size, "datetime64[ms]", LLONG_MIN, &Constant::getLongConst, 0, 1, deferred);
             break;
         }
         case DT_NANOTIME: {
+            if (wrapFastVector(ddbVec, "datetime64[ns]", pyObject))
+                break;
             py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
             ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
             pyObject=std::move(pyVec);
             break;
         }
         case DT_NANOTIMESTAMP: {
+            if (wrapFastVector(ddbVec, "datetime64[ns]", pyObject))
+                break;
             py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
             ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
             pyObject=std::move(pyVec);
             break;
         }
         case DT_DATEHOUR: {
-            if(tableFlag) {
-                py::array pyVec(py::dtype("datetime64[ns]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                long long *p = (long long *)pyVec.mutable_data();
-                if (UNLIKELY(ddbVec->hasNull())) {
-                    DLOG("has null.");
-                    for (size_t i = 0; i < size; ++i) {
-                        if (UNLIKELY(p[i] == INT64_MIN)) {
-                            SET_NPNAN(p + i,1);
-                            continue;
-                        }
-                        p[i] *= 3600000000000ll;
-                    }
-                }
-                else {
-                    for (size_t i = 0; i < size; ++i) {
-                        p[i] *= 3600000000000ll;
-                    }
-                }
-                pyObject=std::move(pyVec);
-            }
-            else {
-                py::array pyVec(py::dtype("datetime64[h]"), {size}, {});
-                ddbVec->getLong(0, size, (long long *)pyVec.mutable_data());
-                pyObject=std::move(pyVec);
-            }
+            if (tableFlag)
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[ns]", INT_MIN, &Constant::getIntConst, 0, 3600000000000ll, deferred);
+            else
+                pyObject = toDatetime64<int>(ddbVec.get(), size, "datetime64[h]", INT_MIN, &Constant::getIntConst, 0, 1, deferred);
             break;
         }
         case DT_FLOAT: {
-            py::array pyVec(py::dtype("float32"), {size}, {});
-            ddbVec->getFloat(0, size, (float *)pyVec.mutable_data());
             if (UNLIKELY(ddbVec->hasNull())) {
-                DLOG("has null.");
-                auto p = (float *)pyVec.mutable_data();
-                float buf[1024];
-                int start = 0;
-                int N = size;
-                while (start < N) {
-                    int len = std::min(N - start, 1024);
-                    ddbVec->getFloat(start, len, buf);
-                    for (int i = 0; i < len; ++i) {
-                        if(UNLIKELY(buf[i] == FLT_NMIN)) {
-                            p[i] = NAN;
-                        }
-                    }
-                    start += len;
-                }
+                pyObject = toFloatingWithNull<float>(ddbVec.get(), size, "float32", FLT_NMIN, &Constant::getFloatConst, deferred);
+                break;
             }
+            if (wrapFastVector(ddbVec, "float32", pyObject))
+                break;
+            py::array pyVec(py::dtype("float32"), {size}, {});
+            ddbVec->getFloat(0, size, (float *)pyVec.mutable_data());
             pyObject=std::move(pyVec);
             break;
         }
         case DT_DOUBLE: {
-            py::array pyVec(py::dtype("float64"), {size}, {});
-            ddbVec->getDouble(0, size, (double *)pyVec.mutable_data());
             if (UNLIKELY(ddbVec->hasNull())) {
-                DLOG("has null.");
-                double *p = (double *)pyVec.mutable_data();
-                double buf[1024];
-                int start = 0;
-                int N = size;
-                while (start < N) {
-                    int len = std::min(N - start, 1024);
-                    ddbVec->getDouble(start, len, buf);
-                    for (int i = 0; i < len; ++i) {
-                        if(UNLIKELY(buf[i] == DBL_NMIN)) {
-                            SET_NPNAN(p + start + i, 1);
-                        }
-                    }
-                    start += len;
-                }
+                pyObject = toFloatingWithNull<double>(ddbVec.get(), size, "float64", DBL_NMIN, &Constant::getDoubleConst, deferred);
+                break;
             }
+            if (wrapFastVector(ddbVec, "float64", pyObject))
+                break;
+            py::array pyVec(py::dtype("float64"), {size}, {});
+            ddbVec->getDouble(0, size, (double *)pyVec.mutable_data());
             pyObject=std::move(pyVec);
             break;
         }
+        case DT_SYMBOL:
+            if (ddbVec->isFastMode() && !ddbVec->getSymbolBase().isNull()) {
+                pyObject = createPySymbols(ddbVec, poption != NULL && poption->symbolAsCategory);
+                break;
+            }
+            //no symbol base, convert row by row like STRING
         case DT_IP:
         case DT_UUID:
         case DT_INT128:
-        case DT_SYMBOL:
         case DT_STRING: {
             py::array pyVec(py::dtype("object"), {size}, {});
             for (size_t i = 0; i < size; ++i) {
@@ -517,7 +609,7 @@ void DdbPythonUtil::createPyVector(const ConstantSP &obj,py::object &pyObject,bo
             // handle numpy.array of objects
             py::list list(size);
             for (size_t i = 0; i < size; ++i) {
-                list[i]=toPython(ddbVec->get(i),false,poption);
+                list[i]=DdbPythonUtil::toPython(ddbVec->get(i),false,poption);
             }
             pyObject = std::move(list);
             break;
@@ -528,6 +620,10 @@ void DdbPythonUtil::createPyVector(const ConstantSP &obj,py::object &pyObject,bo
     }
 }
 
+void DdbPythonUtil::createPyVector(const ConstantSP &obj,py::object &pyObject,bool tableFlag,const ToPythonOption *poption){
+    convertPyVector(obj, pyObject, tableFlag, poption, NULL);
+}
+
 py::object DdbPythonUtil::toPython(ConstantSP obj,bool tableFlag,const ToPythonOption *poption) {
     //RECORDTIME("toPython");
     if (obj.isNull() || obj->isNothing() || obj->isNull()){
@@ -575,11 +671,11 @@ py::object DdbPythonUtil::toPython(ConstantSP obj,bool tableFlag,const ToPythonO
                 }
                 VectorSP valueSP = arrayVector->getFlatValueArray();
                 py::object py1darray;
-                createPyVector(valueSP, py1darray, tableFlag, poption);
-                py::array py2DVec(py1darray);
+                ToPythonOption flatOption(*poption);
+                flatOption.nullableDtype = false;
+                createPyVector(valueSP, py1darray, tableFlag, &flatOption);
                 size_t rows = arrayVector->rows();
-                py2DVec.resize( {rows, cols} );
-                pyObject = std::move(py2DVec);;
+                pyObject = py1darray.attr("reshape")(rows, cols);
             }
         }else{
             createPyVector(obj,pyObject,tableFlag,poption);
@@ -587,16 +683,30 @@ py::object DdbPythonUtil::toPython(ConstantSP obj,bool tableFlag,const ToPythonO
     } else if (form == DF_TABLE) {
         TableSP ddbTbl = obj;
         if(poption->table2List==false){
+            // Convert every column first and build the DataFrame once. Adding the columns one by one
+            // to an existing DataFrame inserts a block per column and makes pandas consolidate again and again.
+            // The numpy arrays are allocated here with the GIL held, the fills that only read the DolphinDB
+            // columns (null patching, temporal scaling) then run in parallel with the GIL released.
             size_t columnSize = ddbTbl->columns();
             using namespace py::literals;
-            py::array first = toPython(ddbTbl->getColumn(0), true);
-            auto colName = py::list();
-            colName.append(py::str(ddbTbl->getColumnName(0)));
-            py::object dataframe = Preserved::pandas_.attr("DataFrame")(first, "columns"_a = colName);
-            for (size_t i = 1; i < columnSize; ++i) {
-                dataframe[ddbTbl->getColumnName(i).data()] = toPython(ddbTbl->getColumn(i), true, poption);
+            py::dict columns;
+            vector<ColumnConvertPool::Task> tasks;
+            for (size_t i = 0; i < columnSize; ++i) {
+                ConstantSP column = ddbTbl->getColumn(i);
+                py::object pyColumn;
+                if (column->getForm() == DF_VECTOR && column->getType() < ARRAY_TYPE_BASE)
+                    convertPyVector(column, pyColumn, true, poption, &tasks);
+                else
+                    pyColumn = toPython(column, true, poption);
+                columns[py::str(ddbTbl->getColumnName(i))] = pyColumn;
+            }
+            if (!tasks.empty()) {
+                //small tables are filled on this thread, a thread hop costs more than the fill
+                size_t rows = ddbTbl->rows();
+                py::gil_scoped_release release;
+                ColumnConvertPool::run(tasks, rows * tasks.size() >= 65536);
             }
-            pyObject=std::move(dataframe);
+            pyObject = Preserved::pandas_.attr("DataFrame")(columns, "copy"_a = false);
         }else{
             size_t columnSize = ddbTbl->columns();
             py::list pyList(columnSize);
@@ -686,11 +796,12 @@ py::object DdbPythonUtil::toPython(ConstantSP obj,bool tableFlag,const ToPythonO
         // FIXME: currently only support numerical matrix
         if (ddbMat->getCategory() == MIXED) { throw RuntimeException("currently only support single typed matrix"); }
         ddbMat->setForm(DF_VECTOR);
-        py::array pyMat = toPython(ddbMat,false,poption);
+        ToPythonOption matOption(*poption);
+        matOption.nullableDtype = false;
+        py::object pyMat = toPython(ddbMat,false,&matOption);
         py::object pyMatRowLabel = toPython(ddbMat->getRowLabel(),false,poption);
         py::object pyMatColLabel = toPython(ddbMat->getColumnLabel(),false,poption);
-        pyMat.resize({cols, rows});
-        pyMat = pyMat.attr("transpose")();
+        pyMat = pyMat.attr("reshape")(cols, rows).attr("transpose")();
         py::list pyMatList;
         pyMatList.append(pyMat);
         pyMatList.append(pyMatRowLabel);
@@ -752,70 +863,433 @@ DATA_TYPE numpyToDolphinDBType(py::array &array) {
         return DT_DATETIME;
     else if (type.equal(Preserved::npobject_)){
         return DT_OBJECT;
-    }else{
+    }else{
+        return DT_OBJECT;
+    }
+}
+
+//pandas nullable arrays (Int8/Int16/Int32/Int64/boolean) keep the values and a bool mask of missing elements.
+//Convert them directly instead of going through an object array of numbers and pd.NA.
+static bool createMaskedVector(const py::object &series, DATA_TYPE typeIndicator, ConstantSP &ddbResult) {
+    py::object extArray = series.attr("array");
+    if (!py::hasattr(extArray, "_mask") || !py::hasattr(extArray, "_data"))
+        return false;
+    py::array data = Preserved::numpy_.attr("ascontiguousarray")(extArray.attr("_data"));
+    py::array mask = Preserved::numpy_.attr("ascontiguousarray")(extArray.attr("_mask"));
+    if (data.ndim() != 1 || mask.size() != data.size() || !mask.dtype().equal(Preserved::npbool_))
+        return false;
+    DATA_TYPE type = numpyToDolphinDBType(data);
+    if (typeIndicator != DT_OBJECT && typeIndicator != type)
+        return false;
+    int size = data.size();
+    const unsigned char *pmask = (const unsigned char*)mask.data();
+    VectorSP ddbVec;
+    bool hasNull;
+    switch (type) {
+        case DT_BOOL:
+        case DT_CHAR:
+            ddbVec = Util::createVector(type, size, size);
+            hasNull = NullKernel::applyMask((const char*)data.data(), pmask, size, CHAR_MIN, (char*)ddbVec->getDataArray());
+            break;
+        case DT_SHORT:
+            ddbVec = Util::createVector(type, size, size);
+            hasNull = NullKernel::applyMask((const short*)data.data(), pmask, size, SHRT_MIN, (short*)ddbVec->getDataArray());
+            break;
+        case DT_INT:
+            ddbVec = Util::createVector(type, size, size);
+            hasNull = NullKernel::applyMask((const int*)data.data(), pmask, size, INT_MIN, (int*)ddbVec->getDataArray());
+            break;
+        case DT_LONG:
+            ddbVec = Util::createVector(type, size, size);
+            hasNull = NullKernel::applyMask((const long long*)data.data(), pmask, size, LLONG_MIN, (long long*)ddbVec->getDataArray());
+            break;
+        default:
+            return false;
+    }
+    ddbVec->setNullFlag(hasNull);
+    ddbResult = ddbVec;
+    return true;
+}
+
+static inline bool isValueNull(long long value){
+    return value == npLongNan_;
+}
+
+static inline bool isValueNull(double value){
+    uint64_t r;
+    memcpy(&r, &value, sizeof(r));
+    return r == npDoubleNan_;
+}
+
+//Make sure pyVec is a C-contiguous array of the given dtype, converting it only when necessary.
+static inline void makeContiguous(py::array &pyVec, const py::object &dtype) {
+    if (!pyVec.dtype().equal(dtype) || (pyVec.flags() & py::array::c_style) == 0)
+        pyVec = pyVec.attr("astype")(dtype);
+}
+
+//datetime64 and int64 arrays share the same 64-bit layout, NaT is INT64_MIN.
+static inline void makeContiguousInt64(py::array &pyVec) {
+    py::dtype dtype = pyVec.dtype();
+    if ((dtype.kind() != 'M' && !dtype.equal(Preserved::npint64_)) || (pyVec.flags() & py::array::c_style) == 0)
+        pyVec = pyVec.attr("astype")("int64");
+}
+
+//Encode an array of str (or bytes) into one contiguous buffer of NUL-terminated strings, the layout
+//PackedStringVector serializes from. offsets[i] is the position of the i-th string, offsets[size] the total.
+//The UTF-8 form cached by CPython is read directly and compact ASCII strings are copied from their
+//character data, so no Python or C++ object is created per element. None and NaN become "".
+//If the string type was only guessed (verify), an element other than str, None or NaN makes it return false
+//instead of throwing, so the caller can fall back to a full type inference.
+static bool encodeStrings(py::array &pyVec, int size, vector<char> &data, vector<long long> &offsets, bool &containNull, bool verify = false) {
+    makeContiguous(pyVec, Preserved::npobject_);
+    PyObject **objs = (PyObject**)pyVec.data();
+    data.clear();
+    data.reserve((size_t)size * 8);
+    offsets.resize(size + 1);
+    containNull = false;
+    for (int i = 0; i < size; ++i) {
+        PyObject *obj = objs[i];
+        const char *str;
+        Py_ssize_t length;
+        if (PyUnicode_Check(obj)) {
+            if (PyUnicode_IS_COMPACT_ASCII(obj)) {
+                str = (const char*)PyUnicode_DATA(obj);
+                length = PyUnicode_GET_LENGTH(obj);
+            }
+            else if ((str = PyUnicode_AsUTF8AndSize(obj, &length)) == NULL) {
+                throw py::error_already_set();
+            }
+        }
+        else if (PyBytes_Check(obj) && !verify) {
+            str = PyBytes_AS_STRING(obj);
+            length = PyBytes_GET_SIZE(obj);
+        }
+        else if (obj == Py_None || (PyFloat_Check(obj) && std::isnan(PyFloat_AS_DOUBLE(obj)))) {
+            str = "";
+            length = 0;
+        }
+        else if (verify) {
+            return false;
+        }
+        else {
+            throw RuntimeException("Cannot convert " + py::str(py::handle(obj).get_type()).cast<std::string>() + " to string.");
+        }
+        offsets[i] = data.size();
+        data.insert(data.end(), str, str + length);
+        data.push_back('\0');
+        containNull |= (length == 0);
+    }
+    offsets[size] = data.size();
+    return true;
+}
+
+//pandas Categorical columns keep the distinct strings in categories and an integer code per row (-1 for missing).
+//Build the symbol base from the categories only and translate the codes into symbol ids.
+static bool createCategoricalVector(const py::object &series, DATA_TYPE typeIndicator, ConstantSP &ddbResult) {
+    if (typeIndicator != DT_OBJECT && typeIndicator != DT_SYMBOL)
+        return false;
+    py::object dtype = series.attr("dtype");
+    if (!py::hasattr(dtype, "categories") || !py::hasattr(series, "cat"))
+        return false;
+    py::array categories = series.attr("cat").attr("categories").attr("values");
+    int categoryCount = categories.size();
+    //pandas gives the categories of an all-missing Categorical a float64 dtype
+    if (categories.ndim() != 1 || (categoryCount > 0 && !categories.dtype().equal(Preserved::npobject_)))
+        return false;
+    PyObject **pcategories = (PyObject**)categories.data();
+    for (int i = 0; i < categoryCount; ++i) {
+        if (!PyUnicode_Check(pcategories[i]))
+            return false;
+    }
+    vector<char> data;
+    vector<long long> offsets;
+    bool containNull;
+    encodeStrings(categories, categoryCount, data, offsets, containNull);
+
+    //id 0 is the empty string, even when there is no category at all, e.g. a column of missing values
+    SymbolBaseSP base = new SymbolBase(0);
+    base->findAndInsert("");
+    vector<int> ids(categoryCount);
+    for (int i = 0; i < categoryCount; ++i)
+        ids[i] = base->findAndInsert(string(data.data() + offsets[i], offsets[i + 1] - offsets[i] - 1));
+
+    py::array codes = series.attr("cat").attr("codes");
+    makeContiguous(codes, Preserved::npint32_);
+    const int *pcodes = (const int*)codes.data();
+    int size = codes.size();
+    int *symbols = new int[size];
+    containNull = false;
+    for (int i = 0; i < size; ++i) {
+        int code = pcodes[i];
+        symbols[i] = code >= 0 && code < categoryCount ? ids[code] : 0;
+        containNull |= (symbols[i] == 0);
+    }
+    ddbResult = new FastSymbolVector(base, size, size, symbols, containNull);
+    return true;
+}
+
+//Elements checked before guessing the type of an object array: the head and an evenly spaced sample of the rest.
+static const int TYPE_SAMPLE_HEAD = 32;
+static const int TYPE_SAMPLE_SPREAD = 96;
+
+//Guess the type of an object array from a sample of its elements instead of inspecting every one.
+//Only a column of strings is guessed, and the guess is verified by the conversion itself.
+//Returns DT_OBJECT if the full inference is needed.
+static DATA_TYPE sampleObjectType(const py::array &pyVec) {
+    if (pyVec.ndim() != 1)
+        return DT_OBJECT;
+    if (pyVec.dtype().kind() == 'U')
+        return DT_STRING;
+    if (!pyVec.dtype().equal(Preserved::npobject_) || (pyVec.flags() & py::array::c_style) == 0)
         return DT_OBJECT;
+    int size = pyVec.size();
+    PyObject **objs = (PyObject**)pyVec.data();
+    int step = std::max(1, (size - TYPE_SAMPLE_HEAD) / TYPE_SAMPLE_SPREAD);
+    bool hasString = false;
+    for (int i = 0; i < size; i += (i < TYPE_SAMPLE_HEAD ? 1 : step)) {
+        PyObject *obj = objs[i];
+        if (PyUnicode_Check(obj))
+            hasString = true;
+        else if (obj != Py_None && !(PyFloat_Check(obj) && std::isnan(PyFloat_AS_DOUBLE(obj))))
+            return DT_OBJECT;
     }
+    return hasString ? DT_STRING : DT_OBJECT;
 }
 
-static inline bool isValueNull(long long value){
-    return value == npLongNan_;
+//Convert an array whose elements were guessed or remembered to be strings. Returns false if one is not.
+static bool createInferredStringVector(py::array &pyVec, ConstantSP &ddbResult) {
+    vector<char> data;
+    vector<long long> offsets;
+    bool containNull;
+    if (!encodeStrings(pyVec, pyVec.size(), data, offsets, containNull, true))
+        return false;
+    ddbResult = new PackedStringVector(std::move(data), std::move(offsets), containNull);
+    return true;
 }
 
-static inline bool isValueNull(double value){
-    uint64_t r;
-    memcpy(&r, &value, sizeof(r));
-    return r == npDoubleNan_;
-}
+//Column types of recently uploaded DataFrames, keyed by column names, dtypes and __DolphinDB_Type__, least
+//recently used first out. A type is only remembered when the dtype decides it, or for strings in object
+//columns, which are verified while converting. DT_OBJECT means the column has to be inferred again.
+class SchemaCache {
+public:
+    //The schema of a DataFrame. The hash is combined once while the columns are collected,
+    //a lookup only compares the fields of the entry with the same hash.
+    struct Schema {
+        vector<std::string> names;
+        vector<long long> dtypes;
+        vector<DATA_TYPE> indicators;
+        size_t hash = 0;
+
+        void add(std::string name, const py::object &dtype, DATA_TYPE indicator) {
+            long long dtypeHash = -1;
+            //numpy dtypes hash their kind, size, byte order and datetime unit, other dtypes only count by class
+            if (py::isinstance<py::dtype>(dtype))
+                dtypeHash = PyObject_Hash(dtype.ptr());
+            if (dtypeHash == -1) {
+                PyErr_Clear();
+                dtypeHash = (long long)(size_t)Py_TYPE(dtype.ptr());
+            }
+            combine(std::hash<std::string>()(name));
+            names.push_back(std::move(name));
+            dtypes.push_back(dtypeHash);
+            indicators.push_back(indicator);
+            combine((size_t)dtypeHash);
+            combine((size_t)indicator);
+        }
+
+        bool operator==(const Schema &other) const {
+            return dtypes == other.dtypes && indicators == other.indicators && names == other.names;
+        }
+
+    private:
+        void combine(size_t value) {
+            hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+    };
+
+    static SchemaCache &instance() {
+        static SchemaCache cache;
+        return cache;
+    }
+
+    bool get(const Schema &schema, vector<DATA_TYPE> &types) {
+        LockGuard<Mutex> guard(&mutex_);
+        auto it = index_.find(schema.hash);
+        if (it == index_.end() || !(it->second->first == schema))
+            return false;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        types = it->second->second;
+        return true;
+    }
+
+    void put(const Schema &schema, const vector<DATA_TYPE> &types) {
+        LockGuard<Mutex> guard(&mutex_);
+        auto it = index_.find(schema.hash);
+        if (it != index_.end()) {
+            //same schema, or another one with the same hash, which is replaced
+            it->second->first = schema;
+            it->second->second = types;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        entries_.emplace_front(schema, types);
+        index_[schema.hash] = entries_.begin();
+        if (entries_.size() > CAPACITY) {
+            index_.erase(entries_.back().first.hash);
+            entries_.pop_back();
+        }
+    }
+
+    //the type to remember for a converted DataFrame column
+    static DATA_TYPE typeToRemember(const py::object &column, const ConstantSP &ddbColumn) {
+        py::object dtype = py::getattr(column, "dtype", py::none());
+        if (!py::isinstance<py::dtype>(dtype))
+            return DT_OBJECT;
+        if (py::reinterpret_borrow<py::dtype>(dtype).kind() != 'O')
+            return ddbColumn->getType();
+        return ddbColumn->getType() == DT_STRING ? DT_STRING : DT_OBJECT;
+    }
+
+private:
+    static const size_t CAPACITY = 256;
+    typedef std::list<std::pair<Schema, vector<DATA_TYPE>>> EntryList;
+    Mutex mutex_;
+    EntryList entries_;
+    std::unordered_map<size_t, EntryList::iterator> index_;
+};
+
+//Fast vector which serializes straight from the memory of a NumPy array.
+//It keeps a reference to the array, so the buffer stays valid while the vector is alive.
+//The reference is a raw PyObject*, a py::object member would be hidden inside an exported type.
+template <class BaseVector, typename T>
+class NumpyBorrowedVector : public BaseVector {
+public:
+    NumpyBorrowedVector(const py::array &array, int size) : BaseVector(size, size, (T*)array.data(), false), array_(array.ptr()) {
+        this->externalData_ = true;
+        Py_INCREF(array_);
+    }
+    virtual ~NumpyBorrowedVector(){
+        //the vector may be released on a thread without GIL, e.g. the writer threads
+        ProtectGil protectGil;
+        Py_DECREF(array_);
+    }
+private:
+    PyObject *array_;
+};
 
 template <typename T>
-void processData(T *psrcData, int size, std::function<void(T *, int)> f) {
-    int bufsize = std::min(1024, size);
-    T buf[bufsize];
-    int startIndex = 0, len;
-    while(startIndex < size){
-        len = std::min(size-startIndex, bufsize);
-        memcpy(buf, psrcData+startIndex, sizeof(T)*len);
-        f(buf,len);
-        startIndex += len;
+static inline bool hasNumpyNan(const T *data, int size) {
+    for (int i = 0; i < size; ++i) {
+        if (data[i] != data[i])
+            return true;
     }
+    return false;
 }
 
-void AddVectorData(VectorSP &ddbVec, py::array &pyVec, DATA_TYPE type,int size) {
-    //RECORDTIME(Util::getDataTypeString(type)+"AddVectorData");
-    DLOG("{ AddVectorData",Util::getDataTypeString(type),size,"start");
+//Return a vector borrowing the buffer of pyVec when its memory layout is exactly what DolphinDB expects,
+//otherwise a null pointer and the caller has to copy the data.
+static Vector* createBorrowedVector(py::array &pyVec, DATA_TYPE type, int size) {
+    if (size <= 0 || (pyVec.flags() & py::array::c_style) == 0 || (pyVec.flags() & py::detail::npy_api::NPY_ARRAY_ALIGNED_) == 0)
+        return NULL;
+    py::dtype dtype = pyVec.dtype();
     switch (type) {
-        case DT_BOOL: {
-            pyVec = pyVec.attr("astype")("int8");
-            ddbVec->appendBool((char*)pyVec.data(), size);
+        case DT_BOOL:
+            if (dtype.equal(Preserved::npbool_))
+                return new NumpyBorrowedVector<FastBoolVector, char>(pyVec, size);
             break;
-        }
-        case DT_CHAR: {
-            pyVec = pyVec.attr("astype")("int8");
-            ddbVec->appendChar((char*)pyVec.data(), size);
+        case DT_CHAR:
+            if (dtype.equal(Preserved::npint8_))
+                return new NumpyBorrowedVector<FastCharVector, char>(pyVec, size);
             break;
-        }
-        case DT_SHORT: {
-            //append<short>(pyVec, size, [&](short *buf, int size) { ddbVec->appendShort(buf, size); });
-            pyVec = pyVec.attr("astype")("int16");
-            ddbVec->appendShort((short*)pyVec.data(),size);
+        case DT_SHORT:
+            if (dtype.equal(Preserved::npint16_))
+                return new NumpyBorrowedVector<FastShortVector, short>(pyVec, size);
             break;
-        }
-        case DT_INT: {
-            //append<int>(pyVec, size, [&](int *buf, int size) { ddbVec->appendInt(buf, size); });
-            pyVec = pyVec.attr("astype")("int32");
-            ddbVec->appendInt((int*)pyVec.data(),size);
+        case DT_INT:
+            if (dtype.equal(Preserved::npint32_))
+                return new NumpyBorrowedVector<FastIntVector, int>(pyVec, size);
             break;
-        }
-        case DT_MONTH: {
-            pyVec = pyVec.attr("astype")("int64");
-            processData<long long>((long long*)pyVec.data(), size, [&](long long *buf, int size) {
-                for(int i = 0; i < size; ++i)
-                    buf[i] += 23640;
-                ddbVec->appendLong(buf, size);
-            });
+        case DT_LONG:
+            if (dtype.equal(Preserved::npint64_))
+                return new NumpyBorrowedVector<FastLongVector, long long>(pyVec, size);
             break;
-        }
+        case DT_TIMESTAMP:
+            if (dtype.equal(Preserved::npdatetime64ms_()))
+                return new NumpyBorrowedVector<FastTimestampVector, long long>(pyVec, size);
+            break;
+        case DT_NANOTIMESTAMP:
+            if (dtype.equal(Preserved::npdatetime64ns_()))
+                return new NumpyBorrowedVector<FastNanoTimestampVector, long long>(pyVec, size);
+            break;
+        //NaN has to be translated to the DolphinDB null value, which can't be done in place
+        case DT_FLOAT:
+            if (dtype.equal(Preserved::npfloat32_) && !hasNumpyNan((const float*)pyVec.data(), size))
+                return new NumpyBorrowedVector<FastFloatVector, float>(pyVec, size);
+            break;
+        case DT_DOUBLE:
+            if (dtype.equal(Preserved::npfloat64_) && !hasNumpyNan((const double*)pyVec.data(), size))
+                return new NumpyBorrowedVector<FastDoubleVector, double>(pyVec, size);
+            break;
+        default:
+            break;
+    }
+    return NULL;
+}
+
+//The datetime64 dtype counting in the unit of a temporal type, None for the types without one.
+static py::object datetime64DType(DATA_TYPE type) {
+    switch (type) {
+        case DT_DATE:
+            return Preserved::npdatetime64D_();
+        case DT_MONTH:
+            return Preserved::npdatetime64M_();
+        case DT_DATETIME:
+            return Preserved::npdatetime64s_();
+        case DT_DATEHOUR:
+            return Preserved::npdatetime64h_();
+        case DT_TIMESTAMP:
+            return Preserved::npdatetime64ms_();
+        case DT_NANOTIMESTAMP:
+            return Preserved::npdatetime64ns_();
+        default:
+            return py::none();
+    }
+}
+
+//Whether prepareVectorData converts an array of this dtype to the type by value: numbers for the numeric
+//types, datetime64 for the temporal types it can rescale. Anything else would be parsed or reinterpreted.
+static bool fitsVectorData(const py::array &pyVec, DATA_TYPE type) {
+    char kind = pyVec.dtype().kind();
+    switch (type) {
+        case DT_BOOL:
+        case DT_CHAR:
+        case DT_SHORT:
+        case DT_INT:
+        case DT_LONG:
+        case DT_FLOAT:
+        case DT_DOUBLE:
+            return kind == 'b' || kind == 'i' || kind == 'u' || kind == 'f';
+        default:
+            return kind == 'M' && !datetime64DType(type).is_none();
+    }
+}
+
+//Convert pyVec to the C-contiguous layout fillVectorData reads for the given type. Needs the GIL.
+//Returns false for the types which are not filled from a flat buffer.
+static bool prepareVectorData(py::array &pyVec, DATA_TYPE type) {
+    switch (type) {
+        case DT_BOOL:
+        case DT_CHAR:
+            makeContiguous(pyVec, Preserved::npint8_);
+            return true;
+        case DT_SHORT:
+            makeContiguous(pyVec, Preserved::npint16_);
+            return true;
+        case DT_INT:
+            makeContiguous(pyVec, Preserved::npint32_);
+            return true;
         case DT_DATE:
+        case DT_MONTH:
         case DT_TIME:
         case DT_MINUTE:
         case DT_SECOND:
@@ -825,67 +1299,105 @@ void AddVectorData(VectorSP &ddbVec, py::array &pyVec, DATA_TYPE type,int size)
         case DT_NANOTIME:
         case DT_NANOTIMESTAMP:
         case DT_LONG: {
-            //append<long long>(pyVec, size, [&](long long *buf, int size) { ddbVec->appendLong(buf, size); });
-            pyVec = pyVec.attr("astype")("int64");
-            ddbVec->appendLong((long long*)pyVec.data(),size);
+            //the int64 view of datetime64 counts in its own unit, rescale it to the unit of the type first
+            py::object dtype = datetime64DType(type);
+            if (pyVec.dtype().kind() == 'M' && !dtype.is_none())
+                makeContiguous(pyVec, dtype);
+            makeContiguousInt64(pyVec);
+            return true;
+        }
+        case DT_FLOAT:
+            makeContiguous(pyVec, Preserved::npfloat32_);
+            return true;
+        case DT_DOUBLE:
+            makeContiguous(pyVec, Preserved::npfloat64_);
+            return true;
+        default:
+            return false;
+    }
+}
+
+//Fill an empty vector with the elements of a buffer prepared by prepareVectorData, translating NaN/NaT
+//to nulls. It only touches C++ memory, so it may run with the GIL released.
+static void fillVectorData(Vector *ddbVec, const void *src, DATA_TYPE type, int size) {
+    switch (type) {
+        case DT_BOOL:
+            ddbVec->appendBool((char*)src, size);
             break;
-        }
-        case DT_FLOAT: {
-            //append<float>(pyVec, size, [&](float *buf, int size) { ddbVec->appendFloat(buf, size); });
-            pyVec = pyVec.attr("astype")("float32");
-            bool hasnull=false;
-            processData<float>((float*)pyVec.data(), size, [&](float *buf, int size) {
-                for(int i=0; i < size;i++){
-                    if(buf[i]==NAN) {
-                        buf[i] = FLT_NMIN;
-                        hasnull=true;
-                    }
-                }
-                ddbVec->appendFloat(buf, size);
-            });
-            ddbVec->setNullFlag(hasnull);
+        case DT_CHAR:
+            ddbVec->appendChar((char*)src, size);
+            break;
+        case DT_SHORT:
+            ddbVec->appendShort((short*)src, size);
+            break;
+        case DT_INT:
+            ddbVec->appendInt((int*)src, size);
+            break;
+        case DT_DATE:
+        case DT_MONTH:
+        case DT_TIME:
+        case DT_MINUTE:
+        case DT_SECOND:
+        case DT_DATETIME:
+        case DT_DATEHOUR: {
+            //DolphinDB months are counted from 0000.01M, numpy's from 1970.01M
+            long long offset = type == DT_MONTH ? 23640 : 0;
+            ddbVec->resize(size);
+            ddbVec->setNullFlag(NullKernel::translateDatetime64((const long long*)src, size, offset, (int*)ddbVec->getDataArray()));
             break;
         }
-        case DT_DOUBLE: {
-            pyVec = pyVec.attr("astype")("float64");
-            bool hasnull=false;
-            processData<double>((double*)pyVec.data(), size, [&](double *buf, int size) {
-                for(int i=0; i < size;i++){
-                    if(buf[i] == NAN) {
-                        buf[i] = DBL_NMIN;
-                        hasnull=true;
-                    }
-                }
-                ddbVec->appendDouble(buf, size);
-            });
-            ddbVec->setNullFlag(hasnull);
+        case DT_TIMESTAMP:
+        case DT_NANOTIME:
+        case DT_NANOTIMESTAMP:
+        case DT_LONG:
+            ddbVec->resize(size);
+            ddbVec->setNullFlag(NullKernel::translateDatetime64((const long long*)src, size, 0, (long long*)ddbVec->getDataArray()));
+            break;
+        case DT_FLOAT:
+            ddbVec->resize(size);
+            ddbVec->setNullFlag(NullKernel::translateFloat((const float*)src, size, (float*)ddbVec->getDataArray()));
+            break;
+        case DT_DOUBLE:
+            ddbVec->resize(size);
+            ddbVec->setNullFlag(NullKernel::translateDouble((const double*)src, size, (double*)ddbVec->getDataArray()));
+            break;
+        default:
+            throw RuntimeException("type error in numpy: " + Util::getDataTypeString(type));
+    }
+}
+
+void AddVectorData(VectorSP &ddbVec, py::array &pyVec, DATA_TYPE type,int size) {
+    //RECORDTIME(Util::getDataTypeString(type)+"AddVectorData");
+    DLOG("{ AddVectorData",Util::getDataTypeString(type),size,"start");
+    if (prepareVectorData(pyVec, type)) {
+        fillVectorData(ddbVec.get(), pyVec.data(), type, size);
+        DLOG("AddVectorData",Util::getDataTypeString(type),size,"end }");
+        return;
+    }
+    switch (type) {
+        case DT_BLOB:
+        case DT_STRING: {
+            vector<char> data;
+            vector<long long> offsets;
+            bool containNull;
+            encodeStrings(pyVec, size, data, offsets, containNull);
+            ddbVec = new PackedStringVector(std::move(data), std::move(offsets), containNull, type == DT_BLOB);
             break;
         }
         case DT_IP:
         case DT_UUID:
         case DT_INT128:
-        case DT_SYMBOL:
-        case DT_BLOB:
-        case DT_STRING:
-        {
-            vector<std::string> strs;
-            strs.reserve(size);
-            char *buffer;
-            ssize_t length;
-            for (auto it = pyVec.begin(); it != pyVec.end(); ++it) {
-                PyObject *utf8obj = PyUnicode_AsUTF8String(it->ptr());
-                if (utf8obj != NULL){
-                    PyBytes_AsStringAndSize(utf8obj, &buffer, &length);
-                    std::string str;
-                    str.assign(buffer, (size_t)length);
-                    strs.emplace_back(std::move(str));
-                    Py_DECREF(utf8obj);
-                }else{
-                    DLOG("can't get utf-8 object from string.");
-                }
-                //strs.emplace_back(py::reinterpret_borrow<py::str>(*it).cast<std::string>());
-            }
-            ddbVec->appendString(strs.data(), strs.size());
+        case DT_SYMBOL: {
+            vector<char> data;
+            vector<long long> offsets;
+            bool containNull;
+            encodeStrings(pyVec, size, data, offsets, containNull);
+            vector<char*> strs(size);
+            for (int i = 0; i < size; ++i)
+                strs[i] = data.data() + offsets[i];
+            ddbVec->appendString(strs.data(), size);
+            if (containNull)
+                ddbVec->setNullFlag(true);
             break;
         }
         case DT_ANY: {
@@ -1234,12 +1746,156 @@ DATA_TYPE getChildrenType(const vector<py::object> &children, DdbPythonUtil::ANY
     return type;
 }
 
+//dolphindb.ArrayVector. Imported on first use, the package itself imports this module.
+static bool isArrayVectorObject(const py::object &obj) {
+    static PyObject *arrayVectorType = NULL;
+    static bool imported = false;
+    if (!imported) {
+        imported = true;
+        try {
+            arrayVectorType = py::object(py::module::import("dolphindb.vector").attr("ArrayVector")).release().ptr();
+        } catch (py::error_already_set &) {
+            arrayVectorType = NULL;
+        }
+    }
+    return arrayVectorType != NULL && PyObject_IsInstance(obj.ptr(), arrayVectorType) == 1;
+}
+
+//Build an array vector from the flat values of all rows and the end offset of each row.
+//index is owned by the function. The values are borrowed when possible, otherwise converted in one pass.
+//Returns false if the values can't be converted as a whole, e.g. UUID, strings or datetime64 for TIME.
+static bool buildArrayVector(py::array &values, INDEX *index, int rows, DATA_TYPE eleType, ConstantSP &ddbResult) {
+    std::unique_ptr<INDEX[]> indexGuard(index);
+    if (values.ndim() != 1)
+        throw RuntimeException("The values of an array vector must be a 1-D numpy array.");
+    if (eleType == DT_OBJECT)
+        eleType = numpyToDolphinDBType(values);
+    int size = values.size();
+    if (rows > 0 && index[rows - 1] != size)
+        throw RuntimeException("The last offset of an array vector must equal the number of values " + std::to_string(size) + ".");
+    VectorSP valueVec = createBorrowedVector(values, eleType, size);
+    if (valueVec.isNull()) {
+        if (!fitsVectorData(values, eleType) || !prepareVectorData(values, eleType))
+            return false;
+        valueVec = Util::createVector(eleType, 0, size);
+        fillVectorData(valueVec.get(), values.data(), eleType, size);
+    }
+    DATA_TYPE type = (DATA_TYPE)(eleType + ARRAY_TYPE_BASE);
+    if (rows == 0) {
+        ddbResult = Util::createArrayVector(type, 0);
+        return true;
+    }
+    VectorSP indexVec = Util::createVector(DT_INT, rows, rows, true, 0, indexGuard.release());
+    ddbResult = Util::createArrayVector(indexVec, valueVec);
+    return true;
+}
+
+//ArrayVector(values, offsets)
+static ConstantSP createArrayVectorFromOffsets(const py::object &obj, DATA_TYPE eleType) {
+    py::array values = obj.attr("values");
+    py::array offsets = obj.attr("offsets");
+    if (offsets.ndim() != 1 || (offsets.dtype().kind() != 'i' && offsets.dtype().kind() != 'u'))
+        throw RuntimeException("The offsets of an array vector must be a 1-D integer numpy array.");
+    makeContiguousInt64(offsets);
+    const long long *src = (const long long*)offsets.data();
+    int rows = offsets.size();
+    INDEX *index = new INDEX[rows];
+    long long prev = 0;
+    for (int i = 0; i < rows; ++i) {
+        if (src[i] < prev || src[i] > INT_MAX) {
+            delete[] index;
+            throw RuntimeException("The offsets of an array vector must be non-decreasing and less than 2^31.");
+        }
+        index[i] = (INDEX)src[i];
+        prev = src[i];
+    }
+    ConstantSP result;
+    if (!buildArrayVector(values, index, rows, eleType, result))
+        throw RuntimeException("Cannot create array vector of " + Util::getDataTypeString(eleType) + " from values of dtype " +
+                               py::str(values.dtype()).cast<std::string>() + ".");
+    return result;
+}
+
+//2-D numpy array, one array vector row per array row.
+static bool createArrayVectorFrom2D(py::array array, DATA_TYPE eleType, ConstantSP &ddbResult) {
+    int rows = array.shape(0);
+    long long cols = array.shape(1);
+    if (rows * cols > INT_MAX)
+        throw RuntimeException("An array vector can't exceed 2 billion values.");
+    py::array values = Preserved::numpy_.attr("ascontiguousarray")(array).attr("reshape")(-1);
+    INDEX *index = new INDEX[rows];
+    for (int i = 0; i < rows; ++i)
+        index[i] = (INDEX)((i + 1) * cols);
+    return buildArrayVector(values, index, rows, eleType, ddbResult);
+}
+
+//Object column whose cells are 1-D arrays or lists of numbers: concatenate them with numpy in one call.
+//Returns false if a cell doesn't fit, the caller then converts cell by cell.
+static bool createArrayVectorFromRows(py::array &cells, DATA_TYPE eleType, ConstantSP &ddbResult) {
+    int rows = cells.size();
+    if (cells.ndim() != 1 || !cells.dtype().equal(Preserved::npobject_) || rows == 0)
+        return false;
+    py::list parts(rows);
+    std::unique_ptr<INDEX[]> index(new INDEX[rows]);
+    long long total = 0;
+    PyObject **items = (PyObject**)cells.data();
+    int stride = cells.strides(0) / sizeof(PyObject*);
+    for (int i = 0; i < rows; ++i) {
+        py::handle cell(items[(size_t)i * stride]);
+        if (py::isinstance(cell, Preserved::nparray_)) {
+            if (py::reinterpret_borrow<py::array>(cell).ndim() != 1)
+                return false;
+        } else if (!py::isinstance(cell, Preserved::pylist_) && !py::isinstance(cell, Preserved::pytuple_)) {
+            return false;
+        }
+        total += py::len(cell);
+        if (total > INT_MAX)
+            return false;
+        index[i] = (INDEX)total;
+        parts[i] = cell;
+    }
+    py::array values;
+    try {
+        values = Preserved::numpy_.attr("concatenate")(parts);
+    } catch (py::error_already_set &) {
+        return false;
+    }
+    if (values.ndim() != 1 || values.size() != total)
+        return false;
+    if (eleType == DT_OBJECT && numpyToDolphinDBType(values) == DT_OBJECT)
+        return false;
+    return buildArrayVector(values, index.release(), rows, eleType, ddbResult);
+}
+
+//Vectorized array vector construction: ArrayVector objects, and 2-D numpy arrays or object columns of rows
+//when an array vector type is expected.
+static bool createArrayVectorFast(const py::object &obj, DATA_TYPE typeIndicator, ConstantSP &ddbResult) {
+    DATA_TYPE eleType = typeIndicator >= ARRAY_TYPE_BASE ? (DATA_TYPE)(typeIndicator - ARRAY_TYPE_BASE) : DT_OBJECT;
+    if (isArrayVectorObject(obj)) {
+        ddbResult = createArrayVectorFromOffsets(obj, eleType);
+        return true;
+    }
+    if (typeIndicator < ARRAY_TYPE_BASE || (!py::isinstance(obj, Preserved::nparray_) && !py::isinstance(obj, Preserved::pdseries_)))
+        return false;
+    py::array pyVec = obj;
+    if (pyVec.ndim() == 2)
+        return createArrayVectorFrom2D(pyVec, eleType, ddbResult);
+    return createArrayVectorFromRows(pyVec, eleType, ddbResult);
+}
+
 bool DdbPythonUtil::createVectorMatrix(py::object obj, DATA_TYPE typeIndicator, ConstantSP &ddbResult, ANY_ARRAY_VECTOR_OPTION option){
     //RECORDTIME("createVectorMatrix");
     vector<py::object> children;
     size_t rows, cols;
     bool isArrayVector = (typeIndicator >= ARRAY_TYPE_BASE);
     DATA_TYPE type = typeIndicator;
+    if(isArrayVector && createArrayVectorFast(obj, typeIndicator, ddbResult)){
+        return true;
+    }
+    if(isArrayVector==false && py::isinstance(obj, Preserved::pdseries_) &&
+        (createMaskedVector(obj, type, ddbResult) || createCategoricalVector(obj, type, ddbResult))){
+        return true;
+    }
     if(isArrayVector==false&&
         (py::isinstance(obj, Preserved::nparray_)
             ||py::isinstance(obj, Preserved::pdseries_))){
@@ -1250,6 +1906,9 @@ bool DdbPythonUtil::createVectorMatrix(py::object obj, DATA_TYPE typeIndicator,
             DLOG("nparray_series_dim", dim);
             if(type == DT_OBJECT){
                 type = numpyToDolphinDBType(pyVec);
+                if(type == DT_OBJECT && sampleObjectType(pyVec) == DT_STRING && createInferredStringVector(pyVec, ddbResult)){
+                    return true;
+                }
                 if(type == DT_OBJECT){
                     DATA_TYPE nullType = DT_OBJECT;
                     py::object obj;
@@ -1261,6 +1920,9 @@ bool DdbPythonUtil::createVectorMatrix(py::object obj, DATA_TYPE typeIndicator,
                             break;
                         }
                     }
+                    if(isArrayVector && createArrayVectorFromRows(pyVec, DT_OBJECT, ddbResult)){
+                        return true;
+                    }
                     if(isArrayVector==false){
                         if(type == DT_OBJECT){//Is all none???
                             if(nullType != DT_OBJECT){//Set null object type
@@ -1273,9 +1935,11 @@ bool DdbPythonUtil::createVectorMatrix(py::object obj, DATA_TYPE typeIndicator,
             }
             if(isArrayVector==false && type != DT_OBJECT){
                 int size = pyVec.size();
-                VectorSP ddbVec;
-                ddbVec = Util::createVector(type, 0, size);
-                AddVectorData(ddbVec,pyVec,type,size);
+                VectorSP ddbVec = createBorrowedVector(pyVec, type, size);
+                if(ddbVec.isNull()){
+                    ddbVec = Util::createVector(type, 0, size);
+                    AddVectorData(ddbVec,pyVec,type,size);
+                }
                 ddbResult=ddbVec;
                 return true;
             }
@@ -1414,10 +2078,92 @@ bool DdbPythonUtil::createVectorMatrix(py::object obj, DATA_TYPE typeIndicator,
     return true;
 }
 
+//First phase of the DataFrame conversion, run with the GIL held. A numeric or temporal column is borrowed,
+//or brought to the layout fillVectorData reads and paired with a task filling an empty vector in the
+//second phase. Returns false for the columns createVectorMatrix has to convert.
+static bool prepareColumn(const py::object &column, DATA_TYPE type, ConstantSP &ddbColumn, vector<py::array> &buffers,
+                          vector<ColumnConvertPool::Task> &tasks) {
+    if (type >= ARRAY_TYPE_BASE || !py::isinstance(column, Preserved::pdseries_) || !py::isinstance<py::dtype>(column.attr("dtype")))
+        return false;
+    py::array pyVec = column;
+    if (pyVec.ndim() != 1)
+        return false;
+    if (type == DT_OBJECT)
+        type = numpyToDolphinDBType(pyVec);
+    int size = pyVec.size();
+    VectorSP ddbVec = createBorrowedVector(pyVec, type, size);
+    if (ddbVec.isNull()) {
+        if (!prepareVectorData(pyVec, type))
+            return false;
+        ddbVec = Util::createVector(type, 0, size);
+        buffers.push_back(pyVec);
+        Vector *pVec = ddbVec.get();
+        const void *src = pyVec.data();
+        tasks.push_back([pVec, src, type, size]() { fillVectorData(pVec, src, type, size); });
+    }
+    ddbColumn = ddbVec;
+    return true;
+}
+
+//Objects implementing the Arrow PyCapsule interface, e.g. pyarrow (>= 14) arrays, record batches and tables.
+static bool createFromArrow(const py::object &obj, ConstantSP &ddbConst) {
+    if (py::hasattr(obj, "__arrow_c_array__")) {
+        py::tuple capsules = obj.attr("__arrow_c_array__")();
+        ArrowSchema *schema = (ArrowSchema*)PyCapsule_GetPointer(capsules[0].ptr(), "arrow_schema");
+        ArrowArray *array = (ArrowArray*)PyCapsule_GetPointer(capsules[1].ptr(), "arrow_array");
+        if (schema == NULL || array == NULL)
+            throw py::error_already_set();
+        ddbConst = ArrowBridge::importArray(schema, array);
+        return true;
+    }
+    if (py::hasattr(obj, "__arrow_c_stream__")) {
+        py::object capsule = obj.attr("__arrow_c_stream__")();
+        ArrowArrayStream *stream = (ArrowArrayStream*)PyCapsule_GetPointer(capsule.ptr(), "arrow_array_stream");
+        if (stream == NULL)
+            throw py::error_already_set();
+        py::gil_scoped_release release;
+        ddbConst = ArrowBridge::importStream(stream);
+        return true;
+    }
+    return false;
+}
+
+static void releaseSchemaCapsule(PyObject *capsule) {
+    ArrowSchema *schema = (ArrowSchema*)PyCapsule_GetPointer(capsule, "arrow_schema");
+    if (schema->release != NULL)
+        schema->release(schema);
+    delete schema;
+}
+
+static void releaseArrayCapsule(PyObject *capsule) {
+    ArrowArray *array = (ArrowArray*)PyCapsule_GetPointer(capsule, "arrow_array");
+    if (array->release != NULL)
+        array->release(array);
+    delete array;
+}
+
+py::tuple DdbPythonUtil::toArrow(const ConstantSP &obj) {
+    ArrowSchema *schema = new ArrowSchema();
+    ArrowArray *array = new ArrowArray();
+    try {
+        ArrowBridge::exportConstant(obj, schema, array);
+    } catch (...) {
+        delete schema;
+        delete array;
+        throw;
+    }
+    py::object schemaCapsule = py::reinterpret_steal<py::object>(PyCapsule_New(schema, "arrow_schema", releaseSchemaCapsule));
+    py::object arrayCapsule = py::reinterpret_steal<py::object>(PyCapsule_New(array, "arrow_array", releaseArrayCapsule));
+    return py::make_tuple(schemaCapsule, arrayCapsule);
+}
+
 ConstantSP DdbPythonUtil::toDolphinDB(py::object obj, DATA_FORM formIndicator, DATA_TYPE typeIndicator) {
     //RECORDTIME("toDolphinDB");
     DLOG("{ toDolphinDB start",Util::getDataTypeString(typeIndicator).data(),Util::getDataFormString(formIndicator).data());
     ConstantSP ddbConst;
+    if(isObjArray(obj) == false && createArrayVectorFast(obj, typeIndicator, ddbConst)){
+        return ddbConst;
+    }
     if(isObjArray(obj) == false || createVectorMatrix(obj, typeIndicator, ddbConst, AAV_ANYVECTOR) == false){//it's not vector
         if(formIndicator == DF_VECTOR){// Exception: vector is expected
             throw RuntimeException("Unexpected DF_VECTOR form type "+py::str(obj.get_type()).cast<std::string>());
@@ -1450,24 +2196,59 @@ ConstantSP DdbPythonUtil::toDolphinDB(py::object obj, DATA_FORM formIndicator, D
             }
             //DLOG("toDolphinDB.pddataframe.3");
 
-            vector<ConstantSP> columns;
-            columns.reserve(columnSize);
-            DATA_TYPE type;
+            //The schema: column names, dtypes and type indicators
+            vector<py::object> pyColumns(columnSize);
+            vector<DATA_TYPE> indicators(columnSize);
+            SchemaCache::Schema schema;
             for (size_t i = 0; i < columnSize; ++i) {
-                DLOG("pddataframe column" , i);
-                py::object boject;
                 if (typeIndicators.contains(columnNames[i].data())) {
-                    type = static_cast<DATA_TYPE>(typeIndicators[columnNames[i].data()].cast<int>());
+                    indicators[i] = static_cast<DATA_TYPE>(typeIndicators[columnNames[i].data()].cast<int>());
                 }else{
-                    type = DT_OBJECT;
+                    indicators[i] = DT_OBJECT;
+                }
+                pyColumns[i] = dataframe[columnNames[i].data()];
+                schema.add(std::move(columnNames[i]), py::getattr(pyColumns[i], "dtype", py::none()), indicators[i]);
+            }
+            vector<DATA_TYPE> cachedTypes;
+            bool cached = SchemaCache::instance().get(schema, cachedTypes);
+            vector<DATA_TYPE> typesToRemember(columnSize);
+
+            //Phase one holds the GIL: numeric and temporal columns only take buffer views, other columns are converted.
+            //Phase two fills the numeric and temporal vectors on the pool with the GIL released.
+            vector<ConstantSP> columns(columnSize);
+            vector<py::array> buffers;
+            vector<ColumnConvertPool::Task> tasks;
+            DATA_TYPE type;
+            for (size_t i = 0; i < columnSize; ++i) {
+                DLOG("pddataframe column" , i);
+                type = indicators[i];
+                const py::object &column = pyColumns[i];
+                if (type == DT_OBJECT && cached) {
+                    if (cachedTypes[i] != DT_STRING) {
+                        type = cachedTypes[i];
+                    } else {
+                        py::array pyVec = column;
+                        if (createInferredStringVector(pyVec, columns[i])) {
+                            typesToRemember[i] = DT_STRING;
+                            continue;
+                        }
+                    }
                 }
-                ConstantSP ddbColumn;
-                if(createVectorMatrix(py::array(dataframe[columnNames[i].data()]), type, ddbColumn, ANY_ARRAY_VECTOR_OPTION::AAV_ARRAYVECTOR) == false){
+                if (!prepareColumn(column, type, columns[i], buffers, tasks) &&
+                    createVectorMatrix(column, type, columns[i], ANY_ARRAY_VECTOR_OPTION::AAV_ARRAYVECTOR) == false){
                     throw RuntimeException("DolphinDB only support vector as column.");
                 }
-                columns.emplace_back(ddbColumn);
+                typesToRemember[i] = SchemaCache::typeToRemember(column, columns[i]);
+            }
+            if (!cached || typesToRemember != cachedTypes)
+                SchemaCache::instance().put(schema, typesToRemember);
+            if (!tasks.empty()) {
+                //small frames are filled on this thread, a thread hop costs more than the copy
+                size_t rows = buffers[0].size();
+                py::gil_scoped_release release;
+                ColumnConvertPool::run(tasks, rows * tasks.size() >= 65536);
             }
-            TableSP ddbTbl = Util::createTable(columnNames, columns);
+            TableSP ddbTbl = Util::createTable(schema.names, columns);
             DLOG("toDolphinDB.pddataframe.end. }");
             //DLOG("toDolphinDB.pddataframe.4");
             ddbConst = ddbTbl;
@@ -1559,6 +2340,8 @@ ConstantSP DdbPythonUtil::toDolphinDB(py::object obj, DATA_FORM formIndicator, D
                 if(typeIndicator == DT_OBJECT){
                     if(isnull){//set null default type: double
                         typeIndicator=DT_DOUBLE;
+                    }else if(createFromArrow(obj, ddbConst)){
+                        return ddbConst;
                     }else{
                         throw RuntimeException("DolphinDB doesn't support Python data " + py::str(obj.get_type()).cast<std::string>());
                     }
@@ -1574,63 +2357,45 @@ ConstantSP DdbPythonUtil::toDolphinDB(py::object obj, DATA_FORM formIndicator, D
     return ddbConst;
 }
 
-py::object DdbPythonUtil::loadPickleFile(const std::string &filepath){
-    py::dict statusDict;
-    string shortFilePath=filepath+"_s";
-    FILE *pf;
-    pf=fopen(shortFilePath.data(),"rb");
-    if(pf==NULL){
-        pf=fopen(filepath.data(),"rb");
-        if(pf==NULL){
-            statusDict["errorCode"]=-1;
-            statusDict["errorInfo"]=filepath+" can't open.";
-            return statusDict;
-        }
-        FILE *pfwrite=fopen(shortFilePath.data(),"wb");
-        if(pfwrite==NULL){
-            statusDict["errorCode"]=-1;
-            statusDict["errorInfo"]=shortFilePath+" can't open.";
-            return statusDict;
-        }
-        char buf[4096];
-        int readlen;
-        {
-            char tmp;
-            char header=0x80;
-            int version;
-            while(fread(&tmp,1,1,pf)==1){
-                while(tmp==header){
-                    if(fread(&tmp,1,1,pf)!=1)
-                        break;
-                    version=(unsigned char)tmp;
-                    DLOG(version);
-                    if(version>=0&&version<=5){
-                        fwrite(&header,1,1,pfwrite);
-                        fwrite(&tmp,1,1,pfwrite);
-                        goto nextread;
-                    }
-                }
-            }
-        }
-    nextread:
-        while((readlen=fread(buf,1,4096,pf))>0){
-            fwrite(buf,1,readlen,pfwrite);
-        }
-        fclose(pf);
-        fclose(pfwrite);
-        pf=fopen(shortFilePath.data(),"rb");
-    }
-    if(pf==NULL){
+//loadPickleFiles reads files from disk in groups of about this many bytes before unpickling them
+#define PICKLE_PREFETCH_BYTES (1LL << 30)
+
+//Open a pickle file and move to its first PROTO opcode, skipping whatever the file has in front of it.
+static bool openPickleFile(const std::string &filepath, SmartPointer<MappedFileInputStream> &in, py::dict &statusDict){
+    in = new MappedFileInputStream();
+    if(in->open(filepath) != OK){
         statusDict["errorCode"]=-1;
         statusDict["errorInfo"]=filepath+" can't open.";
-        return statusDict;
+        return false;
+    }
+    const char *data = in->getData();
+    size_t size = in->getFileSize();
+    //an empty file isn't mapped at all
+    if(size == 0){
+        statusDict["errorCode"]=-1;
+        statusDict["errorInfo"]=filepath+" is empty.";
+        return false;
+    }
+    const char *p = (const char *)memchr(data, 0x80, size);
+    while(p != NULL && p + 1 < data + size){
+        if((unsigned char)p[1] <= 5){
+            in->skipBufferedBytes(p - data);
+            return true;
+        }
+        p = (const char *)memchr(p + 1, 0x80, data + size - p - 1);
     }
-    DataInputStreamSP dis=new DataInputStream(pf);
-    std::unique_ptr<PickleUnmarshall> unmarshall(new PickleUnmarshall(dis));
+    statusDict["errorCode"]=-1;
+    statusDict["errorInfo"]=filepath+" doesn't contain pickled data.";
+    return false;
+}
+
+static py::object unpickleFile(const DataInputStreamSP &in){
+    std::unique_ptr<PickleUnmarshall> unmarshall(new PickleUnmarshall(in));
     IO_ERR ret;
     short flag=0;
     if (!unmarshall->start(flag, true, ret)) {
         unmarshall->reset();
+        py::dict statusDict;
         statusDict["errorCode"]=(int)ret;
         statusDict["errorInfo"]="unmarshall failed";
         return statusDict;
@@ -1642,6 +2407,68 @@ py::object DdbPythonUtil::loadPickleFile(const std::string &filepath){
     return res;
 }
 
+py::object DdbPythonUtil::loadPickleFile(const std::string &filepath){
+    py::dict statusDict;
+    SmartPointer<MappedFileInputStream> in;
+    if(!openPickleFile(filepath, in, statusDict))
+        return statusDict;
+    return unpickleFile(in);
+}
+
+py::list DdbPythonUtil::loadPickleFiles(const vector<std::string> &filepaths){
+    //unpickling needs the GIL, so only reading the files from disk runs in parallel, one group ahead of the unpickling
+    size_t count = filepaths.size();
+    vector<SmartPointer<MappedFileInputStream>> inputs(count);
+    vector<py::object> results(count);
+    for(size_t i = 0; i < count; ++i){
+        py::dict statusDict;
+        if(!openPickleFile(filepaths[i], inputs[i], statusDict)){
+            inputs[i].clear();
+            results[i] = statusDict;
+        }
+    }
+    vector<size_t> groupEnds;
+    vector<vector<ColumnConvertPool::Task>> groupTasks;
+    size_t end = 0;
+    while(end < count){
+        size_t begin = end;
+        long long bytes = 0;
+        vector<ColumnConvertPool::Task> tasks;
+        while(end < count && (end == begin || bytes < PICKLE_PREFETCH_BYTES)){
+            if(!inputs[end].isNull()){
+                //the task holds the stream, the mapping stays valid even if the unpickling fails first
+                SmartPointer<MappedFileInputStream> in = inputs[end];
+                bytes += in->getFileSize();
+                tasks.push_back([in](){ in->prefetch(); });
+            }
+            ++end;
+        }
+        groupEnds.push_back(end);
+        groupTasks.push_back(std::move(tasks));
+    }
+    py::list list;
+    ColumnConvertPool::BatchSP pending;
+    if(!groupTasks.empty())
+        pending = ColumnConvertPool::submit(groupTasks[0]);
+    size_t begin = 0;
+    for(size_t group = 0; group < groupEnds.size(); ++group){
+        {
+            py::gil_scoped_release release;
+            ColumnConvertPool::wait(pending);
+        }
+        pending = group + 1 < groupTasks.size() ? ColumnConvertPool::submit(groupTasks[group + 1]) : ColumnConvertPool::BatchSP();
+        for(size_t i = begin; i < groupEnds[group]; ++i){
+            if(!inputs[i].isNull()){
+                results[i] = unpickleFile(inputs[i]);
+                inputs[i].clear();
+            }
+            list.append(results[i]);
+        }
+        begin = groupEnds[group];
+    }
+    return list;
+}
+
 PytoDdbRowPool::PytoDdbRowPool(MultithreadedTableWriter &writer)
                                 : writer_(writer)
                                 ,exitWhenEmpty_(false)
@@ -1710,46 +2537,81 @@ void PytoDdbRowPool::convertLoop(){
             }
             convertingCount_=convertRows.size();
         }
+        convert(convertRows);
+    }
+}
+
+//Queue converted columns behind the rows added before. Needs the GIL.
+bool PytoDdbRowPool::insertColumns(const vector<ConstantSP> &columns){
+    //hold idle_ so the convert thread can't pass these columns with rows added before them
+    SemLock idleLock(idle_);
+    {
+        py::gil_scoped_release release;
+        idleLock.acquire();
+    }
+    vector<std::vector<py::object>*> convertRows;
+    {
+        LockGuard<Mutex> LockGuard(&mutex_);
+        while(!rows_.empty()){
+            convertRows.push_back(rows_.front());
+            rows_.pop();
+        }
+        convertingCount_=convertRows.size();
+    }
+    if(!convertRows.empty())
+        convert(convertRows);
+    if(isExit())
+        return false;
+    //a numeric column may borrow the buffer of a NumPy array, which the caller is free to change once this returns
+    vector<ConstantSP> ownColumns(columns);
+    for(auto &column : ownColumns){
+        if(column->getCategory() != LITERAL)
+            column = column->getValue();
+    }
+    py::gil_scoped_release release;
+    writer_.insertColumns(ownColumns);
+    return true;
+}
+
+//Convert rows taken from rows_ and insert them into the writer, the rows after a failed one go to failedRows_.
+void PytoDdbRowPool::convert(vector<std::vector<py::object>*> &convertRows){
+    DLOG("convert start ",convertRows.size(),"/",rows_.size());
+    vector<vector<ConstantSP>*> insertRows;
+    insertRows.reserve(convertRows.size());
+    vector<ConstantSP> *pDdbRow = NULL;
+    try
+    {
+        ProtectGil protectGil;
+        const DATA_TYPE *pcolType = writer_.getColType();
+        int i, size;
+        for (auto &prow : convertRows)
         {
-            DLOG("convert start ",convertRows.size(),"/",rows_.size());
-            vector<vector<ConstantSP>*> insertRows;
-            insertRows.reserve(convertRows.size());
-            vector<ConstantSP> *pDdbRow = NULL;
-            try
+            pDdbRow = new vector<ConstantSP>;
+            size = prow->size();
+            for (i = 0; i < size; i++)
             {
-                ProtectGil protectGil;
-                const DATA_TYPE *pcolType = writer_.getColType();
-                int i, size;
-                for (auto &prow : convertRows)
-                {
-                    pDdbRow = new vector<ConstantSP>;
-                    size = prow->size();
-                    for (i = 0; i < size; i++)
-                    {
-                        pDdbRow->push_back(DdbPythonUtil::_toDolphinDBScalar(prow->at(i), pcolType[i]));
-                    }
-                    insertRows.push_back(pDdbRow);
-                    pDdbRow = NULL;
-                    delete prow; // must delete it in GIL lock
-                }
-            }catch (RuntimeException &e){
-                writer_.setError(ErrorCodeInfo::EC_InvalidObject, std::string("Data conversion error: ") + e.what());
-                delete pDdbRow;
-            }
-            if(!insertRows.empty()){
-                writer_.insertUnwrittenData(insertRows);
-            }
-            if (insertRows.size() != convertRows.size()){ // has error, rows left some
-                LockGuard<Mutex> LockGuard(&mutex_);
-                for(size_t i = insertRows.size(); i < convertRows.size(); i++){
-                    failedRows_.push(convertRows[i]);
-                }
+                pDdbRow->push_back(DdbPythonUtil::_toDolphinDBScalar(prow->at(i), pcolType[i]));
             }
-            DLOG("convert end ",insertRows.size(),failedRows_.size(),"/",rows_.size());
-            convertingCount_ = 0;
-            convertRows.clear();
+            insertRows.push_back(pDdbRow);
+            pDdbRow = NULL;
+            delete prow; // must delete it in GIL lock
+        }
+    }catch (RuntimeException &e){
+        writer_.setError(ErrorCodeInfo::EC_InvalidObject, std::string("Data conversion error: ") + e.what());
+        delete pDdbRow;
+    }
+    if(!insertRows.empty()){
+        writer_.insertUnwrittenData(insertRows);
+    }
+    if (insertRows.size() != convertRows.size()){ // has error, rows left some
+        LockGuard<Mutex> LockGuard(&mutex_);
+        for(size_t i = insertRows.size(); i < convertRows.size(); i++){
+            failedRows_.push(convertRows[i]);
         }
     }
+    DLOG("convert end ",insertRows.size(),failedRows_.size(),"/",rows_.size());
+    convertingCount_ = 0;
+    convertRows.clear();
 }
 
 void PytoDdbRowPool::getStatus(MultithreadedTableWriter::Status &status){
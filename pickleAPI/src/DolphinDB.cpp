@@ -10,6 +10,10 @@
 #include <istream>
 #include <stack>
 #ifndef WINDOWS
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <uuid/uuid.h>
 #endif
 #include "Concurrent.h"
@@ -39,6 +43,10 @@ int min(INDEX a, int b) {
 //#define APIMinVersionRequirement 100
 #define APIMinVersionRequirement 210
 #define SYMBOLBASE_MAX_SIZE 1<<21
+#define PIPELINED_RING_SIZE (16 << 20)
+//request bytes a pipelined run keeps in flight. It stays below the socket buffers, so writing a request never waits on a
+//server that is itself blocked writing responses we haven't read yet.
+#define PIPELINE_MAX_INFLIGHT_BYTES (64 << 10)
 
 #define RECORDTIME(name) //RecordTime _recordTime(name)
 #define DLOG //DLogger::Info
@@ -94,12 +102,13 @@ class EXPORT_DECL DBConnectionImpl {
 public:
     DBConnectionImpl(bool sslEnable = false, bool asynTask = false, int keepAliveTime = 7200, bool compress = false, bool enablePickle = true);
     ~DBConnectionImpl();
-    bool connect(const string& hostName, int port, const string& userId = "", const string& password = "");
+    bool connect(const string& hostName, int port, const string& userId = "", const string& password = "", const string& unixSocket = "");
     void login(const string& userId, const string& password, bool enableEncryption);
     ConstantSP run(const string& script, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false);
     ConstantSP run(const string& funcName, vector<ConstantSP>& args, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false);
-    py::object runPy(const string& script, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false, bool pickleTableToList=false);
-    py::object runPy(const string& funcName, vector<ConstantSP>& args, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false, bool pickleTableToList=false);
+    py::object runPy(const string& script, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false);
+    py::object runPy(const string& funcName, vector<ConstantSP>& args, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false);
+    py::list runPyPipelined(const vector<string>& scripts, int priority = 4, int parallelism = 2, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false);
     ConstantSP upload(const string& name, const ConstantSP& obj);
     ConstantSP upload(vector<string>& names, vector<ConstantSP>& objs);
     void close();
@@ -111,17 +120,35 @@ public:
         return sessionId_;
     }
 
+    /**
+     * A run split in two: sendRun and sendRunPy write the request, readResult and readPyResult read its response.
+     * It lets a caller wait for the response on its own terms, e.g. in an event loop, instead of blocking in run.
+     * sendRunPy returns the bytes it wrote ahead of the arguments: the header, the flags line and the script.
+     */
+    void sendRun(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false);
+    size_t sendRunPy(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false);
+    ConstantSP readResult(const string& script, int fetchSize = 0);
+    //in carries bytes buffered past the previous response when several responses are on the way, NULL starts a new stream
+    py::object readPyResult(const string& script, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false,
+                            DataInputStreamSP in = DataInputStreamSP());
+    SocketSP getSocket() const {
+        return conn_;
+    }
+
 private:
     ConstantSP run(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority = 4, int parallelism = 2, int fetchSize = 0, bool clearMemory = false);
-    py::object runPy(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority = 4, int parallelism = 2,int fetchSize = 0, bool clearMemory = false, bool pickleTableToList=false);
+    py::object runPy(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority = 4, int parallelism = 2,int fetchSize = 0, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false);
     bool connect();
     void login();
+    size_t sendRequest(const string& script, const string& scriptType, vector<ConstantSP>& args, long long flag, int priority, int parallelism, int fetchSize);
 
 private:
     SocketSP conn_;
     string sessionId_;
     string hostName_;
     int port_;
+    //path of a Unix domain socket to the same server, an empty path connects through TCP
+    string unixSocket_;
     string userId_;
     string pwd_;
     bool encrypted_;
@@ -132,6 +159,9 @@ private:
     int keepAliveTime_;
 	bool compress_;
     bool enablePickle_;
+    PickleFrameArena pickleFrames_;
+    //unpickler kept between pickle runs so its object setup and memo allocation are paid once per connection
+    std::unique_ptr<PickleUnmarshall> idleUnpickler_;
     static bool initialized_;
 };
 
@@ -175,12 +205,16 @@ public:
         bool isFunc = false;
         bool isPyTask = true;
         bool pickleTableToList=false;
+        bool nullableDtype=false;
+        bool symbolAsCategory=false;
+        bool pipelinedDecode=false;
         bool compress=false;
         bool enablePickle=true;
     };
 
     DBConnectionPoolImpl(const string& hostName, int port, int threadNum = 10, const string& userId = "", const string& password = "",
-            bool loadBalance = true, bool highAvailability = true, bool reConnectFlag = true, bool compress = false,bool enablePickle=true);
+            bool loadBalance = true, bool highAvailability = true, bool reConnectFlag = true, bool compress = false,bool enablePickle=true,
+            int eventLoopThreads = 0);
 
     ~DBConnectionPoolImpl(){
         shutDown();
@@ -192,22 +226,34 @@ public:
         }
     }
     void run(const string& script, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false){
-        queue_->push(Task(script, identity, priority, parallelism, clearMemory, false));
         taskStatus_.setResult(identity, TaskStatusMgmt::Result());
+        queue_->push(Task(script, identity, priority, parallelism, clearMemory, false));
+        wakeEventLoop();
     }
 
     void run(const string& functionName, const vector<ConstantSP>& args, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false){
-        queue_->push(Task(functionName, args, identity, priority, parallelism, clearMemory, false));
         taskStatus_.setResult(identity, TaskStatusMgmt::Result());
+        queue_->push(Task(functionName, args, identity, priority, parallelism, clearMemory, false));
+        wakeEventLoop();
     }
-    void runPy(const string& script, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false, bool pickleTableToList=false){
-        queue_->push(Task(script, identity, priority, parallelism, clearMemory, true,pickleTableToList));
+    void runPy(const string& script, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false){
+        Task task(script, identity, priority, parallelism, clearMemory, true,pickleTableToList);
+        task.nullableDtype = nullableDtype;
+        task.symbolAsCategory = symbolAsCategory;
+        task.pipelinedDecode = pipelinedDecode;
         taskStatus_.setResult(identity, TaskStatusMgmt::Result());
+        queue_->push(task);
+        wakeEventLoop();
     }
 
-    void runPy(const string& functionName, const vector<ConstantSP>& args, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false, bool pickleTableToList=false){
-        queue_->push(Task(functionName, args, identity, priority, parallelism, clearMemory, true,pickleTableToList));
+    void runPy(const string& functionName, const vector<ConstantSP>& args, int identity, int priority=4, int parallelism=2, int fetchSize=0, bool clearMemory = false, bool pickleTableToList=false, bool nullableDtype=false, bool symbolAsCategory=false, bool pipelinedDecode=false){
+        Task task(functionName, args, identity, priority, parallelism, clearMemory, true,pickleTableToList);
+        task.nullableDtype = nullableDtype;
+        task.symbolAsCategory = symbolAsCategory;
+        task.pipelinedDecode = pipelinedDecode;
         taskStatus_.setResult(identity, TaskStatusMgmt::Result());
+        queue_->push(task);
+        wakeEventLoop();
     }
 
     bool isFinished(int identity){
@@ -224,6 +270,7 @@ public:
 
     void shutDown(){
         shutDownFlag_.store(true);
+        wakeEventLoops();
         latch_->wait();
     }
 
@@ -232,17 +279,27 @@ public:
     }
 
     int getConnectionCount(){
-        return workers_.size();
+        return sessionIds_.size();
     }
 
     vector<string> getSessionId(){
         return sessionIds_;
     }
 
+    //wakes one event loop with an idle connection to take a queued task, none if every connection is busy: the IO
+    //thread that finishes a task takes the next one from the queue itself
+    void wakeEventLoop();
+
+private:
+    void wakeEventLoops();
+
 private:
     std::atomic<bool> shutDownFlag_;
     CountDownLatchSP latch_;
     vector<ThreadSP> workers_;
+    //owned by their threads in workers_, empty when every connection has its own AsynWorker
+    vector<PoolEventLoop*> eventLoops_;
+    std::atomic<unsigned> nextEventLoop_;
     SmartPointer<SynchronizedQueue<Task>> queue_;
     TaskStatusMgmt taskStatus_;
     vector<string> sessionIds_;
@@ -272,6 +329,226 @@ private:
     const string password_;
 };
 
+#ifndef WINDOWS
+#define MAX_POOL_EVENTS 64
+#define POOL_WAKE_EVENT 0xFFFFFFFFu
+
+//Drives a share of the pool's connections from one thread. The loop itself never blocks on a socket: a connection
+//with a task goes to one of the loop's IO threads, which writes the request, and is then left to epoll until the
+//response starts to arrive. An IO thread reads and decodes that response with the blocking unmarshallers while the
+//loop goes on with the other connections. The wait for the server, where a pool connection spends most of its time,
+//costs neither a thread nor timed wakeups.
+class PoolEventLoop : public Runnable {
+public:
+    using Task = DBConnectionPoolImpl::Task;
+    PoolEventLoop(DBConnectionPoolImpl& pool, CountDownLatchSP latch, const vector<SmartPointer<DBConnection>>& conns,
+               const SmartPointer<SynchronizedQueue<Task>>& queue, TaskStatusMgmt& status,
+               const string& hostName, int port, const string& userId , const string& password, bool reConnect, int ioThreads);
+    ~PoolEventLoop();
+    //called by the pool after it queued a task or started to shut down
+    void wake();
+    bool hasIdleSlots() const { return idleCount_.load() > 0; }
+
+protected:
+    virtual void run();
+
+private:
+    struct Slot {
+        SmartPointer<DBConnection> conn;
+        Task task;
+        SOCKET handle;
+    };
+    //A slot handed to an IO thread, which owns it until the request is out and watched or the slot is posted back to done_.
+    //Send the request if send is set, read the response otherwise.
+    struct Job {
+        int index;
+        bool send;
+    };
+    class IoWorker : public Runnable {
+    public:
+        IoWorker(PoolEventLoop& loop) : loop_(loop){}
+    protected:
+        virtual void run(){ loop_.work(); }
+    private:
+        PoolEventLoop& loop_;
+    };
+    void dispatch();
+    void release(int index);
+    //run on the IO threads
+    void work();
+    void watch(int index);
+    bool send(int index);
+    void receive(int index);
+    void recover(int index, const string& err);
+
+private:
+    DBConnectionPoolImpl& pool_;
+    CountDownLatchSP latch_;
+    SmartPointer<SynchronizedQueue<Task>> queue_;
+    TaskStatusMgmt& taskStatus_;
+    bool reConnectFlag_;
+    const string hostName_;
+    int port_;
+    const string userId_;
+    const string password_;
+    int epollFd_;
+    int wakeFd_;
+    vector<Slot> slots_;
+    vector<int> idle_;
+    //the size of idle_, for the pool to pick a loop to wake
+    std::atomic<int> idleCount_;
+    int ioThreadCount_;
+    vector<ThreadSP> ioThreads_;
+    SynchronizedQueue<Job> jobs_;
+    //the slots whose tasks are over
+    SynchronizedQueue<int> done_;
+};
+
+//Input stream for a pickled result that keeps receiving from the socket on its own thread while the unpickler
+//decodes, so building the Python objects overlaps with the network transfer instead of waiting on it.
+//The received bytes go through a ring buffer; the reader stops when the ring is full until the unpickler catches up.
+//Nothing borrows the ring: every read copies out of it, into the stream buffer or into the array being filled.
+class PipelinedInputStream : public DataInputStream {
+public:
+    PipelinedInputStream(const SocketSP& socket, const DataInputStreamSP& header, size_t ringSize)
+            : DataInputStream(PIPELINED_SOCKET_STREAM, 65536), ring_(new char[ringSize]), ringSize_(ringSize),
+              head_(0), count_(0), ret_(OK), done_(false), stop_(false){
+        socket_ = socket;
+        reverseOrder_ = header->isIntegerReversed();
+        //bytes of the result already buffered by the stream that read the response header
+        size_t buffered = header->getDataSizeInArray();
+        if(buffered > capacity_){
+            delete[] buf_;
+            buf_ = new char[buffered];
+            capacity_ = buffered;
+        }
+        memcpy(buf_, header->skipBufferedBytes(buffered), buffered);
+        size_ = buffered;
+        if(pipe(wakeFds_) != 0)
+            throw RuntimeException("Failed to create the pipe to stop the socket reader");
+        thread_ = new Thread(new Reader(*this));
+        thread_->start();
+    }
+
+    ~PipelinedInputStream(){
+        {
+            LockGuard<Mutex> guard(&mutex_);
+            stop_ = true;
+            notFull_.notify();
+        }
+        char c = 0;
+        if(::write(wakeFds_[1], &c, 1) < 0)
+            DLogger::Error("Failed to wake up the socket reader");
+        thread_->join();
+        ::close(wakeFds_[0]);
+        ::close(wakeFds_[1]);
+    }
+
+protected:
+    virtual IO_ERR internalStreamRead(char* buf, size_t length, size_t& actualLength){
+        size_t head, count;
+        {
+            LockGuard<Mutex> guard(&mutex_);
+            while(count_ == 0 && !done_)
+                notEmpty_.wait(mutex_);
+            if(count_ == 0){
+                actualLength = 0;
+                return ret_;
+            }
+            head = head_;
+            count = count_;
+        }
+        //only this thread moves head_, and the reader never overwrites the count bytes after it
+        actualLength = std::min(length, count);
+        size_t first = std::min(actualLength, ringSize_ - head);
+        memcpy(buf, ring_.get() + head, first);
+        memcpy(buf + first, ring_.get(), actualLength - first);
+        LockGuard<Mutex> guard(&mutex_);
+        head_ = (head + actualLength) % ringSize_;
+        count_ -= actualLength;
+        notFull_.notify();
+        return OK;
+    }
+
+    virtual IO_ERR internalClose(){
+        return OK;
+    }
+
+private:
+    class Reader : public Runnable {
+    public:
+        Reader(PipelinedInputStream& stream) : stream_(stream){}
+    protected:
+        virtual void run(){ stream_.readSocket(); }
+    private:
+        PipelinedInputStream& stream_;
+    };
+
+    void readSocket(){
+        struct pollfd fds[2];
+        fds[0].fd = socket_->getHandle();
+        fds[0].events = POLLIN;
+        fds[1].fd = wakeFds_[0];
+        fds[1].events = POLLIN;
+        while(true){
+            size_t tail, space;
+            {
+                LockGuard<Mutex> guard(&mutex_);
+                while(count_ == ringSize_ && !stop_)
+                    notFull_.wait(mutex_);
+                if(stop_)
+                    return;
+                tail = (head_ + count_) % ringSize_;
+                space = std::min(ringSize_ - count_, ringSize_ - tail);
+            }
+            //wait on the pipe as well, the stream may be destroyed before the server sends anything more
+            if(poll(fds, 2, -1) < 0){
+                if(errno == EINTR)
+                    continue;
+                finish(OTHERERR);
+                return;
+            }
+            if(fds[1].revents & POLLIN)
+                return;
+            if(!(fds[0].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            size_t actualLength;
+            IO_ERR ret = socket_->read(ring_.get() + tail, space, actualLength);
+            if(ret == NODATA)
+                continue;
+            if(ret != OK){
+                finish(ret);
+                return;
+            }
+            LockGuard<Mutex> guard(&mutex_);
+            count_ += actualLength;
+            notEmpty_.notify();
+        }
+    }
+
+    void finish(IO_ERR ret){
+        LockGuard<Mutex> guard(&mutex_);
+        ret_ = ret;
+        done_ = true;
+        notEmpty_.notify();
+    }
+
+private:
+    std::unique_ptr<char[]> ring_;
+    size_t ringSize_;
+    size_t head_;
+    size_t count_;
+    IO_ERR ret_;
+    bool done_;
+    bool stop_;
+    Mutex mutex_;
+    ConditionalVariable notEmpty_;
+    ConditionalVariable notFull_;
+    int wakeFds_[2];
+    ThreadSP thread_;
+};
+#endif
+
 bool DBConnectionImpl::initialized_ = false;
 string Constant::EMPTY("");
 string Constant::NULL_STR("NULL");
@@ -792,6 +1069,15 @@ DBConnectionImpl::~DBConnectionImpl() {
     if (!conn_.isNull()) {
         conn_->close();
     }
+    if (idleUnpickler_) {
+        if (Py_IsInitialized()) {
+            ProtectGil pgil;
+            idleUnpickler_.reset();
+        }
+        else {
+            idleUnpickler_.release();
+        }
+    }
 }
 
 void DBConnectionImpl::close() {
@@ -803,9 +1089,10 @@ void DBConnectionImpl::close() {
     sessionId_ = "";
 }
 
-bool DBConnectionImpl::connect(const string& hostName, int port, const string& userId,const string& password) {
+bool DBConnectionImpl::connect(const string& hostName, int port, const string& userId,const string& password, const string& unixSocket) {
     hostName_ = hostName;
     port_ = port;
+    unixSocket_ = unixSocket;
     userId_ = userId;
     pwd_ = password;
     return connect();
@@ -819,7 +1106,7 @@ bool DBConnectionImpl::connect() {
     isConnected_ = false;
 
     SocketSP conn = new Socket(hostName_, port_, true, keepAliveTime_, sslEnable_);
-    IO_ERR ret = conn->connect();
+    IO_ERR ret = unixSocket_.empty() ? conn->connect() : conn->connectUnix(unixSocket_, true);
     if (ret != OK) {
         return false;
     }
@@ -960,14 +1247,14 @@ ConstantSP DBConnectionImpl::run(const string& funcName, vector<ConstantSP>& arg
     return run(funcName, "function", args, priority, parallelism, fetchSize, clearMemory);
 }
 
-py::object DBConnectionImpl::runPy(const string &script, int priority, int parallelism, int fetchSize, bool clearMemory, bool pickleTableToList) {
+py::object DBConnectionImpl::runPy(const string &script, int priority, int parallelism, int fetchSize, bool clearMemory, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory, bool pipelinedDecode) {
     vector<ConstantSP> args;
-    return runPy(script, "script", args, priority, parallelism, fetchSize, clearMemory,pickleTableToList);
+    return runPy(script, "script", args, priority, parallelism, fetchSize, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
 }
 
 py::object DBConnectionImpl::runPy(const string &funcName, vector<ConstantSP> &args, int priority, int parallelism,
-                                   int fetchSize, bool clearMemory, bool pickleTableToList) {
-    return runPy(funcName, "function", args, priority, parallelism, fetchSize, clearMemory,pickleTableToList);
+                                   int fetchSize, bool clearMemory, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory, bool pipelinedDecode) {
+    return runPy(funcName, "function", args, priority, parallelism, fetchSize, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
 }
 
 ConstantSP DBConnectionImpl::upload(const string& name, const ConstantSP& obj) {
@@ -994,18 +1281,10 @@ ConstantSP DBConnectionImpl::upload(vector<string>& names, vector<ConstantSP>& o
     return run(varNames, "variable", objs);
 }
 
-ConstantSP DBConnectionImpl::run(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority, int parallelism,
-                                    int fetchSize, bool clearMemory) {
-    DLOG("run1 ",script," start");
+size_t DBConnectionImpl::sendRequest(const string& script, const string& scriptType, vector<ConstantSP>& args, long long flag,
+                                    int priority, int parallelism, int fetchSize) {
     if (!isConnected_)
         throw RuntimeException("Couldn't send script/function to the remote host because the connection has been closed");
-
-    if(fetchSize > 0 && fetchSize < 8192)
-        throw RuntimeException("fetchSize must be greater than 8192");
-    //force Python release GIL
-    SmartPointer<py::gil_scoped_release> pgilRelease;
-    if(PyGILState_Check() == 1)
-        pgilRelease = new py::gil_scoped_release;
     string body;
     int argCount = args.size();
     if (scriptType == "script")
@@ -1018,13 +1297,6 @@ ConstantSP DBConnectionImpl::run(const string& script, const string& scriptType,
     }
     string out("API " + sessionId_ + " ");
     out.append(Util::convert((int)body.size()));
-    short flag = 0; //32+8 means for python api
-    if(asynTask_)
-        flag += 4;
-    if(clearMemory)
-        flag += 16;
-	if (compress_)
-		flag += 64;
     out.append(" / " + std::to_string(flag) + "_1_" + std::to_string(priority) + "_" + std::to_string(parallelism));
     if(fetchSize > 0)
         out.append("__" + std::to_string(fetchSize));
@@ -1061,17 +1333,71 @@ ConstantSP DBConnectionImpl::run(const string& script, const string& scriptType,
         }
     } else {
         size_t actualLength;
-        IO_ERR ret = conn_->write(out.c_str(), out.size(), actualLength);
+        ret = conn_->write(out.c_str(), out.size(), actualLength);
         if (ret != OK) {
             isConnected_ = false;
             conn_.clear();
             throw RuntimeException("Couldn't send script/function to the remote host because the connection has been closed");
         }
     }
+    return out.size();
+}
 
+void DBConnectionImpl::sendRun(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority, int parallelism,
+                                int fetchSize, bool clearMemory) {
+    short flag = 0; //32+8 means for python api
+    if(asynTask_)
+        flag += 4;
+    if(clearMemory)
+        flag += 16;
+	if (compress_)
+		flag += 64;
+    sendRequest(script, scriptType, args, flag, priority, parallelism, fetchSize);
+}
+
+size_t DBConnectionImpl::sendRunPy(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority, int parallelism,
+                                  int fetchSize, bool clearMemory, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory) {
+    long long flag = 32;//32-API
+    //pandas nullable arrays and Categoricals are built from the DolphinDB vectors, so ask for the native protocol instead of pickle
+    if(enablePickle_ == false || nullableDtype || symbolAsCategory){
+        flag += 8;
+        if (compress_)
+            flag += 64;
+    }
+    if(asynTask_)
+        flag += 4;
+    if(clearMemory)
+        flag += 16;
+    if(pickleTableToList)
+        flag += (1<<15);
+    DLOG("runPy flag",flag,"enablePickle_",enablePickle_," pickleTableToList ", pickleTableToList,"compress",compress_);
+    return sendRequest(script, scriptType, args, flag, priority, parallelism, fetchSize);
+}
+
+ConstantSP DBConnectionImpl::run(const string& script, const string& scriptType, vector<ConstantSP>& args, int priority, int parallelism,
+                                    int fetchSize, bool clearMemory) {
+    DLOG("run1 ",script," start");
+    if (!isConnected_)
+        throw RuntimeException("Couldn't send script/function to the remote host because the connection has been closed");
+
+    if(fetchSize > 0 && fetchSize < 8192)
+        throw RuntimeException("fetchSize must be greater than 8192");
+    //force Python release GIL
+    SmartPointer<py::gil_scoped_release> pgilRelease;
+    if(PyGILState_Check() == 1)
+        pgilRelease = new py::gil_scoped_release;
+    sendRun(script, scriptType, args, priority, parallelism, fetchSize, clearMemory);
     if(asynTask_){
         return new Void();
     }
+    return readResult(script, fetchSize);
+}
+
+ConstantSP DBConnectionImpl::readResult(const string& script, int fetchSize) {
+    if (!isConnected_)
+        throw RuntimeException("Couldn't read the response from the remote host because the connection has been closed");
+    IO_ERR ret;
+    short flag;
     DataInputStreamSP in = new DataInputStream(conn_);
     if (littleEndian_ != (char)Util::isLittleEndian())
         in->enableReverseIntegerByteOrder();
@@ -1134,7 +1460,7 @@ ConstantSP DBConnectionImpl::run(const string& script, const string& scriptType,
 
 py::object DBConnectionImpl::runPy(const string &script, const string &scriptType, vector<ConstantSP> &args,
                                        int priority, int parallelism, int fetchSize, bool clearMemory,
-                                       bool pickleTableToList) {
+                                       bool pickleTableToList, bool nullableDtype, bool symbolAsCategory, bool pipelinedDecode) {
     //RecordTime record("Db.runPy");
     DLOG("runPy ",script," start argsize",args.size());
     //force Python release GIL
@@ -1145,81 +1471,27 @@ py::object DBConnectionImpl::runPy(const string &script, const string &scriptTyp
         pgilRelease = new py::gil_scoped_release;
 
     //RecordTime record("Db.server");
-    string body;
-    int argCount = args.size();
-    if (scriptType == "script")
-        body = "script\n" + script;
-    else {
-        body = scriptType + "\n" + script;
-        body.append("\n" + std::to_string(argCount));
-        body.append("\n");
-        body.append(Util::isLittleEndian() ? "1" : "0");
-    }
-    string out("API " + sessionId_ + " ");
-    out.append(Util::convert((int)body.size()));
-    long long flag = 32;//32-API
-    if(enablePickle_ == false){
-        flag += 8;
-        if (compress_)
-            flag += 64;
+    sendRunPy(script, scriptType, args, priority, parallelism, fetchSize, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory);
+    if(asynTask_){
+        return py::none();
     }
-    if(asynTask_)
-        flag += 4;
-    if(clearMemory)
-        flag += 16;
-    if(pickleTableToList)
-        flag += (1<<15);
-    DLOG("runPy flag",flag,"enablePickle_",enablePickle_," pickleTableToList ", pickleTableToList,"compress",compress_);
-    out.append(" / " + std::to_string(flag) + "_1_" + std::to_string(priority) + "_" + std::to_string(parallelism));
-    if(fetchSize > 0)
-        out.append("__" + std::to_string(fetchSize));
-
-    out.append(1, '\n');
-    out.append(body);
+    pgilRelease.clear();
+    return readPyResult(script, pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
+}
 
+py::object DBConnectionImpl::readPyResult(const string& script, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory, bool pipelinedDecode,
+                                          DataInputStreamSP in) {
+    if (!isConnected_)
+        throw RuntimeException("Couldn't read the response from the remote host because the connection has been closed");
+    SmartPointer<py::gil_scoped_release> pgilRelease;
+    if(PyGILState_Check() == 1)
+        pgilRelease = new py::gil_scoped_release;
     IO_ERR ret;
-    if (argCount > 0) {
-        for (int i = 0; i < argCount; ++i) {
-            if (args[i]->containNotMarshallableObject()) {
-                throw RuntimeException("The function argument or uploaded object is not marshallable.");
-            }
-        }
-        DataOutputStreamSP outStream = new DataOutputStream(conn_);
-        ConstantMarshallFactory marshallFactory(outStream);
-        for (int i = 0; i < argCount; ++i) {
-            ConstantMarshall* marshall = marshallFactory.getConstantMarshall(args[i]->getForm());
-            if (i == 0)
-                marshall->start(out.c_str(), out.size(), args[i], true, compress_,ret);
-            else
-                marshall->start(args[i], true, compress_,ret);
-            marshall->reset();
-            if (ret != OK) {
-                isConnected_ = false;
-                conn_.clear();
-                throw RuntimeException("Couldn't send function argument to the remote host with IO error type " + std::to_string(ret));
-            }
-        }
-        ret = outStream->flush();
-        if (ret != OK) {
-            isConnected_ = false;
-            conn_.clear();
-            throw RuntimeException("Failed to marshall code with IO error type " + std::to_string(ret));
-        }
-    } else {
-        size_t actualLength;
-        ret = conn_->write(out.c_str(), out.size(), actualLength);
-        if (ret != OK) {
-            isConnected_ = false;
-            conn_.clear();
-            throw RuntimeException("Couldn't send script/function to the remote host because the connection has been closed");
-        }
+    if (in.isNull()) {
+        in = new DataInputStream(conn_);
+        if (littleEndian_ != (char)Util::isLittleEndian())
+            in->enableReverseIntegerByteOrder();
     }
-    if(asynTask_){
-        return py::none();
-    }
-    DataInputStreamSP in = new DataInputStream(conn_);
-    if (littleEndian_ != (char)Util::isLittleEndian())
-        in->enableReverseIntegerByteOrder();
 
     string line;
     if ((ret = in->readLine(line)) != OK) {
@@ -1280,14 +1552,27 @@ py::object DBConnectionImpl::runPy(const string &script, const string &scriptTyp
         //DLogger::Info("toPython tableToList",pickleTableToList);
         DdbPythonUtil::ToPythonOption option;
         option.table2List=pickleTableToList;
+        option.nullableDtype=nullableDtype;
+        option.symbolAsCategory=symbolAsCategory;
         //RecordTime record("Db.toPython");
         return DdbPythonUtil::toPython(result,false,&option);
     }
     //RecordTime pickleRecord("Db.PickUnma");
     //DLogger::Info("PickleTableToList",pickleTableToList);
+    DataInputStreamSP pickleIn = in;
+#ifndef WINDOWS
+    //an SSL socket may hold decrypted bytes that poll can't see, so only plain sockets are read ahead
+    if(pipelinedDecode && !sslEnable_)
+        pickleIn = new PipelinedInputStream(conn_, in, PIPELINED_RING_SIZE);
+#endif
     pgilRelease.clear();
     ProtectGil pgil;
-    std::unique_ptr<PickleUnmarshall> unmarshall(new PickleUnmarshall(in));
+    //a run re-entering this connection while the idle unpickler is out gets a new one
+    std::unique_ptr<PickleUnmarshall> unmarshall(std::move(idleUnpickler_));
+    if (unmarshall)
+        unmarshall->setInputStream(pickleIn, &pickleFrames_);
+    else
+        unmarshall.reset(new PickleUnmarshall(pickleIn, &pickleFrames_));
     if (!unmarshall->start(retFlag, true, ret)) {
         unmarshall->reset();
         isConnected_ = false;
@@ -1309,11 +1594,66 @@ py::object DBConnectionImpl::runPy(const string &script, const string &scriptTyp
         }
     }
     unmarshall->reset();
+    unmarshall->setInputStream(NULL);
+    idleUnpickler_ = std::move(unmarshall);
     py::object res = py::handle(result).cast<py::object>();
     res.dec_ref();
     return res;
 }
 
+py::list DBConnectionImpl::runPyPipelined(const vector<string>& scripts, int priority, int parallelism, bool clearMemory,
+                                          bool pickleTableToList, bool nullableDtype, bool symbolAsCategory) {
+    if (!isConnected_)
+        throw RuntimeException("Couldn't send script/function to the remote host because the connection has been closed");
+    py::list results(scripts.size());
+    vector<ConstantSP> args;
+    //one stream for all responses, a read may buffer the start of the next one
+    DataInputStreamSP in = new DataInputStream(conn_);
+    if (littleEndian_ != (char)Util::isLittleEndian())
+        in->enableReverseIntegerByteOrder();
+    size_t sent = 0;
+    size_t received = 0;
+    //bytes written for the requests whose responses are still on the way
+    size_t inflight = 0;
+    vector<size_t> requestBytes(scripts.size());
+    //what a request adds to its script, the largest seen so far; only the digits of the body length vary between requests
+    size_t framing = 0;
+    string firstError;
+    while (received < scripts.size()) {
+        {
+            SmartPointer<py::gil_scoped_release> pgilRelease;
+            if(PyGILState_Check() == 1)
+                pgilRelease = new py::gil_scoped_release;
+            while (sent < scripts.size() && (sent == received || inflight + framing + scripts[sent].size() <= PIPELINE_MAX_INFLIGHT_BYTES)) {
+                requestBytes[sent] = sendRunPy(scripts[sent], "script", args, priority, parallelism, 0, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory);
+                framing = std::max(framing, requestBytes[sent] - scripts[sent].size());
+                inflight += requestBytes[sent];
+                ++sent;
+            }
+        }
+        if (!asynTask_) {
+            try {
+                results[received] = readPyResult(scripts[received], pickleTableToList, nullableDtype, symbolAsCategory, false, in);
+            } catch (RuntimeException& ex) {
+                //an error raised by the server leaves the connection in step, so the later responses are still read
+                if (conn_.isNull())
+                    throw;
+                if (firstError.empty())
+                    firstError = ex.what();
+            } catch (...) {
+                //the responses still on the way can't be matched with their scripts anymore
+                close();
+                throw;
+            }
+        }
+        inflight -= requestBytes[received];
+        ++received;
+    }
+    if (!firstError.empty())
+        throw RuntimeException(firstError);
+    return results;
+}
+
 DBConnection::DBConnection(bool enableSSL, bool asynTask, int keepAliveTime, bool compress, bool enablePickle) : 
 	conn_(new DBConnectionImpl(enableSSL, asynTask, keepAliveTime, compress, enablePickle)), uid_(""), pwd_(""), ha_(false), nodes_(nullptr) {
     DBConnection::initialize();
@@ -1340,14 +1680,14 @@ DBConnection::~DBConnection() {
 }
 
 bool DBConnection::connect(const string& hostName, int port, const string& userId, const string& password, const string& startup,
-                           bool ha, const vector<string>& highAvailabilitySites) {
+                           bool ha, const vector<string>& highAvailabilitySites, const string& unixSocket) {
     ha_ = ha;
     initialScript_ = startup;
     // if(keepAliveTime > 0)
     //     keepAliveTime_ = keepAliveTime;
     if (ha_) {
         while (true) {
-            if (conn_->connect(hostName, port, userId, password)) {
+            if (conn_->connect(hostName, port, userId, password, unixSocket)) {
                 uid_ = userId;
                 pwd_ = password;
                 break;
@@ -1391,7 +1731,7 @@ bool DBConnection::connect(const string& hostName, int port, const string& userI
         }
         return true;
     } else {
-        bool ok = conn_->connect(hostName, port, userId, password);
+        bool ok = conn_->connect(hostName, port, userId, password, unixSocket);
         if (ok && !initialScript_.empty()) {
             run(initialScript_);
         }
@@ -1516,10 +1856,10 @@ ConstantSP DBConnection::run(const string& script, int priority, int parallelism
     }
 }
 
-py::object DBConnection::runPy(const string &script, int priority, int parallelism, int fetchSize, bool clearMemory, bool pickleTableToList) {
+py::object DBConnection::runPy(const string &script, int priority, int parallelism, int fetchSize, bool clearMemory, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory, bool pipelinedDecode) {
     if (ha_) {
         try {
-            return conn_->runPy(script, priority, parallelism, fetchSize, clearMemory, pickleTableToList);
+            return conn_->runPy(script, priority, parallelism, fetchSize, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
         } catch (IOException& e) {
             string host;
             int port;
@@ -1532,7 +1872,7 @@ py::object DBConnection::runPy(const string &script, int priority, int paralleli
                         if(!connected() || getNewLeader(err, host, port)){
                             switchDataNode(err);
                         }
-                        return conn_->runPy(script, priority, parallelism, fetchSize, clearMemory, pickleTableToList);
+                        return conn_->runPy(script, priority, parallelism, fetchSize, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
                     } catch (exception& e) {
                         if(i == maxRerunCnt_ - 1) {
                             throw;
@@ -1545,7 +1885,7 @@ py::object DBConnection::runPy(const string &script, int priority, int paralleli
             }
         }
     } else {
-        return conn_->runPy(script, priority, parallelism, fetchSize, clearMemory, pickleTableToList);
+        return conn_->runPy(script, priority, parallelism, fetchSize, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
     }
 }
 
@@ -1583,10 +1923,10 @@ ConstantSP DBConnection::run(const string& funcName, vector<dolphindb::ConstantS
 }
 
 py::object DBConnection::runPy(const string &funcName, vector<ConstantSP> &args, int priority, int parallelism,
-                                     int fetchSize, bool clearMemory, bool pickleTableToList) {
+                                     int fetchSize, bool clearMemory, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory, bool pipelinedDecode) {
         if (ha_) {
         try {
-            return conn_->runPy(funcName, args, priority, parallelism, fetchSize, clearMemory,pickleTableToList);
+            return conn_->runPy(funcName, args, priority, parallelism, fetchSize, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
         } catch (IOException& e) {
             string host;
             int port;
@@ -1599,7 +1939,7 @@ py::object DBConnection::runPy(const string &funcName, vector<ConstantSP> &args,
                         if(!connected() || getNewLeader(err, host, port)){
                             switchDataNode(err);
                         }
-                        return conn_->runPy(funcName, args, priority, parallelism, fetchSize, clearMemory,pickleTableToList);
+                        return conn_->runPy(funcName, args, priority, parallelism, fetchSize, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
                     }catch(exception& e){
                         if(i == maxRerunCnt_ - 1)
                             throw;
@@ -1611,10 +1951,15 @@ py::object DBConnection::runPy(const string &funcName, vector<ConstantSP> &args,
             }
         }
     } else {
-        return conn_->runPy(funcName, args, priority, parallelism, fetchSize, clearMemory,pickleTableToList);
+        return conn_->runPy(funcName, args, priority, parallelism, fetchSize, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
     }
 }
 
+py::list DBConnection::runPyPipelined(const vector<string>& scripts, int priority, int parallelism, bool clearMemory, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory) {
+    //no rerun on another node in HA mode, the scripts before a failure may already have run
+    return conn_->runPyPipelined(scripts, priority, parallelism, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory);
+}
+
 ConstantSP DBConnection::upload(const string& name, const ConstantSP& obj) {
     if (ha_) {
         try {
@@ -1717,10 +2062,11 @@ Domain::Domain(PARTITION_TYPE partitionType, DATA_TYPE partitionColType) : parti
 }
 
 DBConnectionPoolImpl::DBConnectionPoolImpl(const string& hostName, int port, int threadNum, const string& userId, const string& password,
-                            bool loadBalance, bool highAvailability, bool reConnectFlag, bool compress, bool enablePickle) :shutDownFlag_(
-            false), queue_(new SynchronizedQueue<Task>){
+                            bool loadBalance, bool highAvailability, bool reConnectFlag, bool compress, bool enablePickle,
+                            int eventLoopThreads) :shutDownFlag_(
+            false), nextEventLoop_(0), queue_(new SynchronizedQueue<Task>){
     DBConnection::initialize();
-    latch_ = new CountDownLatch(threadNum);
+    vector<SmartPointer<DBConnection>> conns;
     if(!loadBalance){
         for(int i = 0 ;i < threadNum; i++){
             SmartPointer<DBConnection> conn = new DBConnection(false, false, 7200, compress, enablePickle);
@@ -1728,8 +2074,7 @@ DBConnectionPoolImpl::DBConnectionPoolImpl(const string& hostName, int port, int
             if(!ret)
                 throw RuntimeException("Failed to connect to " + hostName + ":" + std::to_string(port));
             sessionIds_.push_back(conn->getSessionId());
-            workers_.push_back(new Thread(new AsynWorker(*this,latch_, conn, queue_, taskStatus_, hostName, port, userId, password, reConnectFlag)));
-            workers_.back()->start();
+            conns.push_back(conn);
         }
     }
     else{
@@ -1755,10 +2100,108 @@ DBConnectionPoolImpl::DBConnectionPoolImpl(const string& hostName, int port, int
             if(!ret)
                 throw RuntimeException("Failed to connect to " + hostName + ":" + std::to_string(port));
             sessionIds_.push_back(conn->getSessionId());
-            workers_.push_back(new Thread(new AsynWorker(*this,latch_, conn, queue_, taskStatus_, hostName, port, userId, password,reConnectFlag)));
+            conns.push_back(conn);
+        }
+    }
+#ifndef WINDOWS
+    if(eventLoopThreads > 0){
+        int loopCount = std::min(eventLoopThreads, threadNum);
+        latch_ = new CountDownLatch(loopCount);
+        for(int i = 0; i < loopCount; i++){
+            vector<SmartPointer<DBConnection>> share;
+            for(int j = i; j < threadNum; j += loopCount)
+                share.push_back(conns[j]);
+            //decoding is CPU work, so the IO threads of all loops together stay near the core count
+            int ioThreads = std::max(1, std::min((int)share.size(), Util::getCoreCount() / loopCount));
+            PoolEventLoop* loop = new PoolEventLoop(*this, latch_, share, queue_, taskStatus_, hostName, port, userId, password, reConnectFlag, ioThreads);
+            eventLoops_.push_back(loop);
+            workers_.push_back(new Thread(loop));
             workers_.back()->start();
         }
+        return;
+    }
+#endif
+    latch_ = new CountDownLatch(threadNum);
+    for(int i = 0 ;i < threadNum; i++){
+        workers_.push_back(new Thread(new AsynWorker(*this,latch_, conns[i], queue_, taskStatus_, hostName, port, userId, password, reConnectFlag)));
+        workers_.back()->start();
+    }
+}
+
+void DBConnectionPoolImpl::wakeEventLoop(){
+#ifndef WINDOWS
+    //round-robin from the loop after the one woken last, so the tasks spread over the loops
+    size_t count = eventLoops_.size();
+    for(size_t i = 0; i < count; ++i){
+        PoolEventLoop* loop = eventLoops_[nextEventLoop_.fetch_add(1) % count];
+        if(loop->hasIdleSlots()){
+            loop->wake();
+            return;
+        }
     }
+#endif
+}
+
+void DBConnectionPoolImpl::wakeEventLoops(){
+#ifndef WINDOWS
+    for(PoolEventLoop* loop : eventLoops_)
+        loop->wake();
+#endif
+}
+
+static void reconnectPoolConnection(DBConnection& conn, const string& hostName, int port, const string& userId, const string& password) {
+    while(true){
+        try {
+            if(conn.connect(hostName, port, userId, password))
+                break;
+            std::cerr << "Connect Failed, retry in one second." << std::endl;
+            Thread::sleep(1000);
+        } catch (IOException &e) {
+            std::cerr << "Connect Failed, retry in one second." << std::endl;
+            Thread::sleep(1000);
+        }
+    }
+}
+
+//Runs a pool task to the end and records its result. An IO error on a lost connection reconnects and runs it again
+//if the pool reconnects; any other IO error fails the task.
+static void executePoolTask(DBConnection& conn, DBConnectionPoolImpl::Task& task, TaskStatusMgmt& taskStatus, bool reConnectFlag,
+                            const string& hostName, int port, const string& userId, const string& password) {
+    ConstantSP result = new Void();
+    py::object pyResult = py::none();
+    while(true) {
+        try {
+            //RecordTime::printAllTime();
+            if(task.isPyTask){
+                if(task.isFunc){
+                    pyResult = conn.runPy(task.script, task.arguments, task.priority, task.parallelism, 0, task.clearMemory,task.pickleTableToList, task.nullableDtype, task.symbolAsCategory, task.pipelinedDecode);
+                }
+                else{
+                    pyResult = conn.runPy(task.script, task.priority, task.parallelism, 0, task.clearMemory,task.pickleTableToList, task.nullableDtype, task.symbolAsCategory, task.pipelinedDecode);
+                }
+            }
+            else {
+                if(task.isFunc){
+                    result = conn.run(task.script, task.arguments, task.priority, task.parallelism, 0, task.clearMemory);
+                }
+                else{
+                    result = conn.run(task.script, task.priority, task.parallelism, 0, task.clearMemory);
+                }
+            }
+            DLOG(RecordTime::printAllTime());
+            break;
+        }
+        catch(IOException & ex){
+            if(reConnectFlag && !conn.connected()){
+                reconnectPoolConnection(conn, hostName, port, userId, password);
+            } else {
+                std::cerr<<"Async task worker come across exception : "<<ex.what()<<std::endl;
+                taskStatus.setResult(task.identity, TaskStatusMgmt::Result(TaskStatusMgmt::ERRORED, Constant::void_, py::none(), ex.what()));
+                return;
+            }
+        }
+    }
+    taskStatus.setResult(task.identity, TaskStatusMgmt::Result(TaskStatusMgmt::FINISHED, result, pyResult));
 }
 
 void AsynWorker::run() {
@@ -1771,61 +2214,217 @@ void AsynWorker::run() {
         }
 
         Task task;
-        ConstantSP result = new Void();
-        py::object pyResult = py::none();
-        bool errorFlag = false;
         if (!queue_->blockingPop(task, 1000))
             continue;
         if(task.script.empty())
             continue;
-        while(true) {
-            try {
-                //RecordTime::printAllTime();
-                if(task.isPyTask){
-                    if(task.isFunc){
-                        pyResult = conn_->runPy(task.script, task.arguments, task.priority, task.parallelism, 0, task.clearMemory,task.pickleTableToList);
-                    }
-                    else{
-                        pyResult = conn_->runPy(task.script, task.priority, task.parallelism, 0, task.clearMemory,task.pickleTableToList);
-                    }
-                }
-                else {
-                    if(task.isFunc){
-                        result = conn_->run(task.script, task.arguments, task.priority, task.parallelism, 0, task.clearMemory);
-                    }
-                    else{
-                        result = conn_->run(task.script, task.priority, task.parallelism, 0, task.clearMemory);
-                    }
-                }
-                DLOG(RecordTime::printAllTime());
-                break;
+        executePoolTask(*conn_, task, taskStatus_, reConnectFlag_, hostName_, port_, userId_, password_);
+    }
+}
+
+#ifndef WINDOWS
+PoolEventLoop::PoolEventLoop(DBConnectionPoolImpl& pool, CountDownLatchSP latch, const vector<SmartPointer<DBConnection>>& conns,
+               const SmartPointer<SynchronizedQueue<Task>>& queue, TaskStatusMgmt& status,
+               const string& hostName, int port, const string& userId , const string& password, bool reConnect, int ioThreads)
+            : pool_(pool), latch_(latch), queue_(queue), taskStatus_(status), reConnectFlag_(reConnect),
+              hostName_(hostName), port_(port), userId_(userId), password_(password), idleCount_((int)conns.size()),
+              ioThreadCount_(ioThreads){
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if(epollFd_ < 0)
+        throw RuntimeException("Failed to create the epoll instance of the connection pool with error code " + std::to_string(errno));
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(wakeFd_ < 0){
+        ::close(epollFd_);
+        throw RuntimeException("Failed to create the wake-up event of the connection pool with error code " + std::to_string(errno));
+    }
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u32 = POOL_WAKE_EVENT;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+    slots_.resize(conns.size());
+    for(size_t i = 0; i < conns.size(); ++i){
+        slots_[i].conn = conns[i];
+        slots_[i].handle = INVALID_SOCKET;
+        idle_.push_back(i);
+    }
+}
+
+PoolEventLoop::~PoolEventLoop(){
+    ::close(wakeFd_);
+    ::close(epollFd_);
+}
+
+void PoolEventLoop::wake(){
+    uint64_t one = 1;
+    if(::write(wakeFd_, &one, sizeof(one)) < 0)
+        DLogger::Error("Failed to wake up the connection pool event loop");
+}
+
+void PoolEventLoop::run(){
+    for(int i = 0; i < ioThreadCount_; ++i){
+        ioThreads_.push_back(new Thread(new IoWorker(*this)));
+        ioThreads_.back()->start();
+    }
+    struct epoll_event events[MAX_POOL_EVENTS];
+    while(true){
+        int index;
+        while(done_.pop(index))
+            release(index);
+        //like an AsynWorker, a loop finishes the tasks it started but takes no new ones once the pool shuts down
+        if(pool_.isShutDown() && idle_.size() == slots_.size()){
+            for(size_t i = 0; i < ioThreads_.size(); ++i)
+                jobs_.push(Job{-1, false});
+            for(ThreadSP& thread : ioThreads_)
+                thread->join();
+            for(Slot& slot : slots_)
+                slot.conn->close();
+            latch_->countDown();
+            break;
+        }
+        if(!pool_.isShutDown())
+            dispatch();
+        int count = epoll_wait(epollFd_, events, MAX_POOL_EVENTS, 1000);
+        for(int i = 0; i < count; ++i){
+            if(events[i].data.u32 == POOL_WAKE_EVENT){
+                uint64_t value;
+                if(::read(wakeFd_, &value, sizeof(value)) < 0 && errno != EAGAIN)
+                    DLogger::Error("Failed to reset the wake-up event of the connection pool", errno);
             }
-            catch(IOException & ex){
-                if(reConnectFlag_ && !conn_->connected()){
-                    while(true){
-                        try {
-                            if(conn_->connect(hostName_, port_, userId_, password_))
-                                break;
-                            std::cerr << "Connect Failed, retry in one second." << std::endl;
-                            Thread::sleep(1000);
-                        } catch (IOException &e) {
-                            std::cerr << "Connect Failed, retry in one second." << std::endl;
-                            Thread::sleep(1000);
-                        }
-                    }
-                } else {
-                    errorFlag = true;
-                    std::cerr<<"Async task worker come across exception : "<<ex.what()<<std::endl;
-                    taskStatus_.setResult(task.identity, TaskStatusMgmt::Result(TaskStatusMgmt::ERRORED, Constant::void_, py::none(), ex.what()));
-                    break;
-                }
+            else{
+                //the response is arriving, stop watching before an IO thread reads it, the read may close the socket
+                //and free its descriptor for another connection
+                int index = events[i].data.u32;
+                epoll_ctl(epollFd_, EPOLL_CTL_DEL, slots_[index].handle, NULL);
+                slots_[index].handle = INVALID_SOCKET;
+                jobs_.push(Job{index, false});
             }
         }
-        if(!errorFlag)
-            taskStatus_.setResult(task.identity, TaskStatusMgmt::Result(TaskStatusMgmt::FINISHED, result, pyResult));
     }
 }
 
+void PoolEventLoop::dispatch(){
+    Task task;
+    while(!idle_.empty() && queue_->pop(task)){
+        if(task.script.empty())
+            continue;
+        int index = idle_.back();
+        idle_.pop_back();
+        idleCount_.store((int)idle_.size());
+        slots_[index].task = task;
+        jobs_.push(Job{index, true});
+    }
+    //two tasks queued at once may have woken this loop for its last idle connection, pass the rest on
+    if(idle_.empty() && queue_->size() > 0)
+        pool_.wakeEventLoop();
+}
+
+//The IO thread that sent the request leaves the slot to the loop's epoll, epoll_ctl is safe next to the loop's epoll_wait.
+void PoolEventLoop::watch(int index){
+    Slot& slot = slots_[index];
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u32 = index;
+    slot.handle = slot.conn->conn_->getSocket()->getHandle();
+    if(epoll_ctl(epollFd_, EPOLL_CTL_ADD, slot.handle, &event) != 0){
+        slot.handle = INVALID_SOCKET;
+        //the response can't be told apart from a later one anymore, so the connection starts over
+        slot.conn->close();
+        jobs_.push(Job{index, false});
+    }
+}
+
+void PoolEventLoop::release(int index){
+    slots_[index].task = Task();
+    idle_.push_back(index);
+    idleCount_.store((int)idle_.size());
+}
+
+void PoolEventLoop::work(){
+    Job job;
+    while(true){
+        jobs_.blockingPop(job);
+        if(job.index < 0)
+            return;
+        if(!job.send){
+            receive(job.index);
+            //the connection is free again, take the next task right here instead of a round trip through the loop
+            Slot& slot = slots_[job.index];
+            slot.task = Task();
+            job.send = !pool_.isShutDown() && queue_->pop(slot.task) && !slot.task.script.empty();
+        }
+        //the loop only hears of a slot again when its task is over, so taking the next task costs it no wakeup
+        if(job.send && send(job.index)){
+            watch(job.index);
+            continue;
+        }
+        done_.push(job.index);
+        wake();
+    }
+}
+
+//Returns true once the request is out, false if the task is over already.
+bool PoolEventLoop::send(int index){
+    Slot& slot = slots_[index];
+    Task& task = slot.task;
+    DBConnectionImpl* conn = slot.conn->conn_.get();
+    string scriptType = task.isFunc ? "function" : "script";
+    try{
+        if(task.isPyTask)
+            conn->sendRunPy(task.script, scriptType, task.arguments, task.priority, task.parallelism, 0, task.clearMemory, task.pickleTableToList, task.nullableDtype, task.symbolAsCategory);
+        else
+            conn->sendRun(task.script, scriptType, task.arguments, task.priority, task.parallelism, 0, task.clearMemory);
+        return true;
+    }
+    catch(exception& ex){
+        recover(index, ex.what());
+        return false;
+    }
+}
+
+void PoolEventLoop::receive(int index){
+    Slot& slot = slots_[index];
+    Task& task = slot.task;
+    DBConnectionImpl* conn = slot.conn->conn_.get();
+    try{
+        if(task.isPyTask){
+            ProtectGil pgil;
+            py::object pyResult = conn->readPyResult(task.script, task.pickleTableToList, task.nullableDtype, task.symbolAsCategory, task.pipelinedDecode);
+            taskStatus_.setResult(task.identity, TaskStatusMgmt::Result(TaskStatusMgmt::FINISHED, Constant::void_, pyResult));
+        }
+        else{
+            ConstantSP result = conn->readResult(task.script);
+            ProtectGil pgil;
+            taskStatus_.setResult(task.identity, TaskStatusMgmt::Result(TaskStatusMgmt::FINISHED, result));
+        }
+    }
+    catch(exception& ex){
+        recover(index, ex.what());
+    }
+}
+
+//A failed task whose connection is gone is run again on a new connection if the pool reconnects. Any other failure,
+//e.g. an error raised by the server on a connection still in step, fails the task.
+void PoolEventLoop::recover(int index, const string& err){
+    Slot& slot = slots_[index];
+    if(reConnectFlag_ && !slot.conn->connected()){
+        //the rerun is blocking, the same as in an AsynWorker, so a switch to another node in HA mode is covered too
+        reconnectPoolConnection(*slot.conn, hostName_, port_, userId_, password_);
+        try{
+            executePoolTask(*slot.conn, slot.task, taskStatus_, reConnectFlag_, hostName_, port_, userId_, password_);
+        }
+        catch(exception& ex){
+            ProtectGil pgil;
+            taskStatus_.setResult(slot.task.identity, TaskStatusMgmt::Result(TaskStatusMgmt::ERRORED, Constant::void_, py::none(), ex.what()));
+        }
+    }
+    else{
+        std::cerr<<"Async task worker come across exception : "<<err<<std::endl;
+        ProtectGil pgil;
+        taskStatus_.setResult(slot.task.identity, TaskStatusMgmt::Result(TaskStatusMgmt::ERRORED, Constant::void_, py::none(), err));
+    }
+}
+#endif
+
 bool TaskStatusMgmt::isFinished(int identity){
     LockGuard<Mutex> guard(&mutex_);
     if(results.count(identity) == 0)
@@ -1861,8 +2460,8 @@ py::object TaskStatusMgmt::getPyData(int identity){
 }
 
 DBConnectionPool::DBConnectionPool(const string& hostName, int port, int threadNum, const string& userId, const string& password, bool loadBalance,
-            bool highAvailability, bool reConnectFlag, bool compress,bool enablePickle){
-    pool_ = new DBConnectionPoolImpl(hostName, port, threadNum, userId, password, loadBalance, highAvailability, reConnectFlag, compress,enablePickle);
+            bool highAvailability, bool reConnectFlag, bool compress,bool enablePickle, int eventLoopThreads){
+    pool_ = new DBConnectionPoolImpl(hostName, port, threadNum, userId, password, loadBalance, highAvailability, reConnectFlag, compress,enablePickle, eventLoopThreads);
 }
 
 void DBConnectionPool::run(const string& script, int identity, int priority, int parallelism, int fetchSize, bool clearMemory){
@@ -1877,16 +2476,16 @@ void DBConnectionPool::run(const string& functionName, const vector<ConstantSP>&
     pool_->run(functionName, args, identity, priority, parallelism, fetchSize, clearMemory);
 }
 
-void DBConnectionPool::runPy(const string& script, int identity, int priority, int parallelism, int fetchSize, bool clearMemory, bool pickleTableToList){
+void DBConnectionPool::runPy(const string& script, int identity, int priority, int parallelism, int fetchSize, bool clearMemory, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory, bool pipelinedDecode){
     if(identity < 0)
         throw RuntimeException("Invalid identity: " + std::to_string(identity) + ". Identity must be a non-negative integer.");
-    pool_->runPy(script, identity, priority, parallelism, fetchSize, clearMemory,pickleTableToList);
+    pool_->runPy(script, identity, priority, parallelism, fetchSize, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
 }
 
-void DBConnectionPool::runPy(const string& functionName, const vector<ConstantSP>& args, int identity, int priority, int parallelism, int fetchSize, bool clearMemory, bool pickleTableToList){
+void DBConnectionPool::runPy(const string& functionName, const vector<ConstantSP>& args, int identity, int priority, int parallelism, int fetchSize, bool clearMemory, bool pickleTableToList, bool nullableDtype, bool symbolAsCategory, bool pipelinedDecode){
     if(identity < 0)
         throw RuntimeException("Invalid identity: " + std::to_string(identity) + ". Identity must be a non-negative integer.");
-    pool_->runPy(functionName, args, identity, priority, parallelism, fetchSize, clearMemory,pickleTableToList);
+    pool_->runPy(functionName, args, identity, priority, parallelism, fetchSize, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
 }
 
 bool DBConnectionPool::isFinished(int identity){
@@ -181,6 +181,8 @@ MultithreadedTableWriter::MultithreadedTableWriter(const std::string& hostName,
         writerThread.threadId = 0;
         writerThread.sentRows = 0;
         writerThread.sendingRows = 0;
+        writerThread.failedRows = 0;
+        writerThread.queuedRows = 0;
 		writerThread.exit = false;
         writerThread.idleSem.release();
         if(i==0){
@@ -199,15 +201,16 @@ MultithreadedTableWriter::MultithreadedTableWriter(const std::string& hostName,
 MultithreadedTableWriter::~MultithreadedTableWriter(){
     waitForThreadCompletion();
 	{
-		std::vector<ConstantSP>* pitem = NULL;
+		WriteItem item;
 		for (auto &thread : threads_) {
-			while (thread.writeQueue.pop(pitem)) {
-				delete pitem;
+			while (thread.writeQueue.pop(item)) {
+				delete item.values;
 			}
-			while (thread.failedQueue.pop(pitem)) {
-				delete pitem;
+			while (thread.failedQueue.pop(item)) {
+				delete item.values;
 			}
 		}
+		std::vector<ConstantSP>* pitem = NULL;
 		while (unusedQueue_.pop(pitem)) {
 			delete pitem;
 		}
@@ -293,6 +296,50 @@ void MultithreadedTableWriter::insert(std::vector<ConstantSP> **records, int rec
     }
 }
 
+void MultithreadedTableWriter::insertColumns(const std::vector<ConstantSP> &columns){
+    RECORDTIME("MTW:insertColumns");
+    INDEX rows = columns[0]->size();
+    if(rows < 1)
+        return;
+    if(threads_.size() == 1){
+        pushItem(threads_[0], WriteItem{new std::vector<ConstantSP>(columns), rows});
+        return;
+    }
+    //route each row to the thread its row insert would go to, then hand every thread its rows in one piece
+    vector<int> threadindexes;
+    if(isPartionedTable_){
+        ConstantSP partitionCol = columns[partitionColumnIdx_];
+        DATA_TYPE type = getColDataType(partitionColumnIdx_);
+        if(partitionCol->getType() != type){
+            VectorSP pvector = Util::createVector(type, 0, rows);
+            pvector->append(partitionCol);
+            partitionCol = pvector;
+        }
+        threadindexes = partitionDomain_->getPartitionKeys(partitionCol);
+    }else{
+        const ConstantSP &threadCol = columns[threadByColIndexForNonPartion_];
+        threadindexes.resize(rows);
+        for(INDEX i = 0; i < rows; i++)
+            threadindexes[i] = threadCol->get(i)->getHash(threads_.size());
+    }
+    vector<vector<INDEX>> threadRows(threads_.size());
+    for(INDEX i = 0; i < rows; i++)
+        threadRows[std::max(threadindexes[i], 0) % threads_.size()].push_back(i);
+    for(size_t t = 0; t < threadRows.size(); t++){
+        INDEX count = threadRows[t].size();
+        if(count < 1)
+            continue;
+        std::vector<ConstantSP> *values = new std::vector<ConstantSP>(columns);
+        if(count < rows){
+            VectorSP index = Util::createVector(DT_INT, 0, count);
+            index->appendInt(threadRows[t].data(), count);
+            for(auto &column : *values)
+                column = column->get(index);
+        }
+        pushItem(threads_[t], WriteItem{values, count});
+    }
+}
+
 void MultithreadedTableWriter::getStatus(Status &status){
     status.isExiting = hasError_.load();
     status.errorCode = errorInfo_.errorCode;
@@ -306,8 +353,8 @@ void MultithreadedTableWriter::getStatus(Status &status){
 		idleLock.acquire();
         threadStatus.threadId = writeThread.threadId;
         threadStatus.sentRows = writeThread.sentRows;
-        threadStatus.unsentRows = writeThread.writeQueue.size() + writeThread.sendingRows;
-        threadStatus.sendFailedRows = writeThread.failedQueue.size();
+        threadStatus.unsentRows = getQueuedRows(writeThread) + writeThread.sendingRows;
+        threadStatus.sendFailedRows = writeThread.failedRows;
         status.plus(threadStatus);
     }
 }
@@ -316,9 +363,36 @@ void MultithreadedTableWriter::getUnwrittenData(std::vector<std::vector<Constant
     for(auto &writeThread : threads_){
         SemLock idleLock(writeThread.idleSem);
         idleLock.acquire();
-        writeThread.failedQueue.pop(unwrittenData, writeThread.failedQueue.size());
-        writeThread.writeQueue.pop(unwrittenData, writeThread.writeQueue.size());
+        std::vector<WriteItem> items;
+        writeThread.failedQueue.pop(items, writeThread.failedQueue.size());
+        writeThread.failedRows = 0;
+        popItems(writeThread, items, writeThread.writeQueue.size());
+        for(auto &item : items)
+            splitItem(item, unwrittenData);
+    }
+}
+
+//The rows of an item as the row insert queues them. Takes over the values of the item.
+void MultithreadedTableWriter::splitItem(const WriteItem &item, std::vector<std::vector<ConstantSP>*> &rows){
+    if(item.rows < 1){
+        rows.push_back(item.values);
+        return;
+    }
+    size_t colSize = item.values->size();
+    for(INDEX row = 0; row < item.rows; row++){
+        std::vector<ConstantSP> *prow = new std::vector<ConstantSP>(colSize);
+        for(size_t col = 0; col < colSize; col++){
+            if(colTypes_[col] >= ARRAY_TYPE_BASE){
+                VectorSP cell = Util::createVector(DT_ANY, 0, 1);
+                cell->append(item.values->at(col)->get(row));
+                prow->at(col) = cell;
+            }else{
+                prow->at(col) = item.values->at(col)->get(row);
+            }
+        }
+        rows.push_back(prow);
     }
+    delete item.values;
 }
 
 void MultithreadedTableWriter::insertThreadWrite(int threadhashkey, std::vector<ConstantSP> *prow){
@@ -326,11 +400,31 @@ void MultithreadedTableWriter::insertThreadWrite(int threadhashkey, std::vector<
         threadhashkey = 0;
     }
     int threadIndex = threadhashkey % threads_.size();
-    WriterThread &writerThread = threads_[threadIndex];
-    writerThread.writeQueue.push(prow);
+    pushItem(threads_[threadIndex], WriteItem{prow, 0});
+}
+
+void MultithreadedTableWriter::pushItem(WriterThread &writerThread, const WriteItem &item){
+    {
+        LockGuard<Mutex> guard(&writerThread.queuedMutex);
+        writerThread.queuedRows += item.rows > 0 ? item.rows : 1;
+        writerThread.writeQueue.push(item);
+    }
     writerThread.nonemptyNotify.notify();
 }
 
+void MultithreadedTableWriter::popItems(WriterThread &writerThread, std::vector<WriteItem> &items, int count){
+    LockGuard<Mutex> guard(&writerThread.queuedMutex);
+    size_t first = items.size();
+    writerThread.writeQueue.pop(items, count);
+    for(size_t i = first; i < items.size(); i++)
+        writerThread.queuedRows -= items[i].rows > 0 ? items[i].rows : 1;
+}
+
+long MultithreadedTableWriter::getQueuedRows(WriterThread &writerThread){
+    LockGuard<Mutex> guard(&writerThread.queuedMutex);
+    return writerThread.queuedRows;
+}
+
 void MultithreadedTableWriter::SendExecutor::run(){
     if(init()==false){
         return;
@@ -347,7 +441,7 @@ void MultithreadedTableWriter::SendExecutor::run(){
             //wait for batchsize
             if (tableWriter_.batchSize_ > 1 && tableWriter_.throttleMilsecond_ > 0) {
                 batchWaitTimeout = Util::getEpochTime() + tableWriter_.throttleMilsecond_;
-                while (isExit() == false && writeThread_.writeQueue.size() < tableWriter_.batchSize_) {//check batchsize
+                while (isExit() == false && tableWriter_.getQueuedRows(writeThread_) < tableWriter_.batchSize_) {//check batchsize
                     diff = batchWaitTimeout - Util::getEpochTime();
                     if (diff > 0) {
                         writeThread_.nonemptyNotify.wait(diff);
@@ -369,7 +463,7 @@ bool MultithreadedTableWriter::SendExecutor::writeAllData(){
     DLOG("writeAllData",writeThread_.writeQueue.size());
     SemLock idleLock(writeThread_.idleSem);
     idleLock.acquire();
-    std::vector<std::vector<ConstantSP>*> items;
+    std::vector<WriteItem> items;
     {
         long size = writeThread_.writeQueue.size();
         if (size < 1){
@@ -378,12 +472,18 @@ bool MultithreadedTableWriter::SendExecutor::writeAllData(){
         if(size > 65535)
             size = 65535;
         items.reserve(size);
-        writeThread_.writeQueue.pop(items, size);
+        tableWriter_.popItems(writeThread_, items, size);
     }
-    int size = items.size();
-    if(size < 1){
+    if(items.empty()){
         return false;
     }
+    //rows inserted column by column come as chunks, which are appended as a whole
+    INDEX size = 0;
+    bool hasChunk = false;
+    for (auto &item : items) {
+        size += item.rows > 0 ? item.rows : 1;
+        hasChunk = hasChunk || item.rows > 0;
+    }
     DLOG("writeAllData",size,"/",writeThread_.writeQueue.size());
     writeThread_.sendingRows = size;
     string runscript;
@@ -398,15 +498,20 @@ bool MultithreadedTableWriter::SendExecutor::writeAllData(){
             INDEX colSize= tableWriter_.colTypes_.size();
 			for (INDEX col = 0; col < colSize; col++) {
 				Vector *pcol = (Vector*) writeTable->getColumn(col).get();
-                std::vector<ConstantSP>** pcur = items.data();
-                if(pcol->getVectorType() != VECTOR_TYPE::ARRAYVECTOR){
-                    for (int i = 0; i < size; i++, pcur++) {
-				    	pcol->set(i, (*pcur)->at(col));
+                if(hasChunk){
+                    pcol->clear();
+                    for (auto &item : items) {
+                        if(!pcol->append(item.values->at(col), item.rows > 0 ? item.rows : 1))
+                            throw RuntimeException("Failed to append data to column " + tableWriter_.colNames_[col]);
+                    }
+                }else if(pcol->getVectorType() != VECTOR_TYPE::ARRAYVECTOR){
+                    for (int i = 0; i < size; i++) {
+				    	pcol->set(i, items[i].values->at(col));
 				    }
                 }else{
                     pcol->clear();
-                    for (int i = 0; i < size; i++, pcur++) {
-				    	pcol->append((*pcur)->at(col));
+                    for (int i = 0; i < size; i++) {
+				    	pcol->append(items[i].values->at(col));
 				    }
                 }
 			}
@@ -434,11 +539,11 @@ bool MultithreadedTableWriter::SendExecutor::writeAllData(){
             {
 				RECORDTIME("MTW:saveTable_clear");
 				for (auto &one : items) {
-					if (tableWriter_.unusedQueue_.size() < 65535) {
-						tableWriter_.unusedQueue_.push(one);
+					if (one.rows < 1 && tableWriter_.unusedQueue_.size() < 65535) {
+						tableWriter_.unusedQueue_.push(one.values);
 					}
 					else {
-						delete one;
+						delete one.values;
 					}
 				}
 			}
@@ -451,6 +556,7 @@ bool MultithreadedTableWriter::SendExecutor::writeAllData(){
     if (writeOK == false){
         for (auto &unwriteItem : items)
             writeThread_.failedQueue.push(unwriteItem);
+        writeThread_.failedRows += size;
         writeThread_.sendingRows = 0;
 	}
 	return true;
@@ -0,0 +1,416 @@
+/*
+ * NullKernel.cpp
+ *
+ * The AVX2 and SSE4.1 versions are compiled with function level target attributes,
+ * so the library itself doesn't require these instruction sets.
+ */
+
+#include "NullKernel.h"
+#include "Types.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NULLKERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace dolphindb {
+
+namespace {
+
+enum INSTRUCTION_SET {IS_SCALAR, IS_SSE41, IS_AVX2};
+
+INSTRUCTION_SET detectInstructionSet(){
+#ifdef NULLKERNEL_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+		return IS_AVX2;
+	if(__builtin_cpu_supports("sse4.1"))
+		return IS_SSE41;
+#endif
+	return IS_SCALAR;
+}
+
+inline INSTRUCTION_SET getSupportedSet(){
+	static const INSTRUCTION_SET set = detectInstructionSet();
+	return set;
+}
+
+template<typename T>
+inline bool translateNaNScalar(const T* src, int len, T nullVal, T* dst){
+	bool hasNull = false;
+	for(int i = 0; i < len; ++i){
+		T value = src[i];
+		bool isNaN = value != value;
+		dst[i] = isNaN ? nullVal : value;
+		hasNull |= isNaN;
+	}
+	return hasNull;
+}
+
+template<typename T>
+inline bool translateNaTScalar(const long long* src, int len, long long offset, T nullVal, T* dst){
+	bool hasNull = false;
+	for(int i = 0; i < len; ++i){
+		long long value = src[i];
+		bool isNaT = value == LLONG_MIN;
+		dst[i] = isNaT ? nullVal : (T)(value + offset);
+		hasNull |= isNaT;
+	}
+	return hasNull;
+}
+
+template<typename T>
+inline bool applyMaskScalar(const T* src, const unsigned char* mask, int len, T nullVal, T* dst){
+	unsigned char any = 0;
+	for(int i = 0; i < len; ++i){
+		dst[i] = mask[i] ? nullVal : src[i];
+		any |= mask[i];
+	}
+	return any != 0;
+}
+
+#ifdef NULLKERNEL_X86
+
+__attribute__((target("avx2")))
+bool translateFloatAvx2(const float* src, int len, float* dst){
+	const __m256 nullVal = _mm256_set1_ps(FLT_NMIN);
+	__m256 anyNaN = _mm256_setzero_ps();
+	int i = 0;
+	for(; i + 8 <= len; i += 8){
+		__m256 value = _mm256_loadu_ps(src + i);
+		__m256 isNaN = _mm256_cmp_ps(value, value, _CMP_UNORD_Q);
+		_mm256_storeu_ps(dst + i, _mm256_blendv_ps(value, nullVal, isNaN));
+		anyNaN = _mm256_or_ps(anyNaN, isNaN);
+	}
+	bool hasNull = translateNaNScalar(src + i, len - i, FLT_NMIN, dst + i);
+	return hasNull || _mm256_movemask_ps(anyNaN) != 0;
+}
+
+__attribute__((target("sse4.1")))
+bool translateFloatSse41(const float* src, int len, float* dst){
+	const __m128 nullVal = _mm_set1_ps(FLT_NMIN);
+	__m128 anyNaN = _mm_setzero_ps();
+	int i = 0;
+	for(; i + 4 <= len; i += 4){
+		__m128 value = _mm_loadu_ps(src + i);
+		__m128 isNaN = _mm_cmpunord_ps(value, value);
+		_mm_storeu_ps(dst + i, _mm_blendv_ps(value, nullVal, isNaN));
+		anyNaN = _mm_or_ps(anyNaN, isNaN);
+	}
+	bool hasNull = translateNaNScalar(src + i, len - i, FLT_NMIN, dst + i);
+	return hasNull || _mm_movemask_ps(anyNaN) != 0;
+}
+
+__attribute__((target("avx2")))
+bool translateDoubleAvx2(const double* src, int len, double* dst){
+	const __m256d nullVal = _mm256_set1_pd(DBL_NMIN);
+	__m256d anyNaN = _mm256_setzero_pd();
+	int i = 0;
+	for(; i + 4 <= len; i += 4){
+		__m256d value = _mm256_loadu_pd(src + i);
+		__m256d isNaN = _mm256_cmp_pd(value, value, _CMP_UNORD_Q);
+		_mm256_storeu_pd(dst + i, _mm256_blendv_pd(value, nullVal, isNaN));
+		anyNaN = _mm256_or_pd(anyNaN, isNaN);
+	}
+	bool hasNull = translateNaNScalar(src + i, len - i, DBL_NMIN, dst + i);
+	return hasNull || _mm256_movemask_pd(anyNaN) != 0;
+}
+
+__attribute__((target("sse4.1")))
+bool translateDoubleSse41(const double* src, int len, double* dst){
+	const __m128d nullVal = _mm_set1_pd(DBL_NMIN);
+	__m128d anyNaN = _mm_setzero_pd();
+	int i = 0;
+	for(; i + 2 <= len; i += 2){
+		__m128d value = _mm_loadu_pd(src + i);
+		__m128d isNaN = _mm_cmpunord_pd(value, value);
+		_mm_storeu_pd(dst + i, _mm_blendv_pd(value, nullVal, isNaN));
+		anyNaN = _mm_or_pd(anyNaN, isNaN);
+	}
+	bool hasNull = translateNaNScalar(src + i, len - i, DBL_NMIN, dst + i);
+	return hasNull || _mm_movemask_pd(anyNaN) != 0;
+}
+
+__attribute__((target("avx2")))
+bool translateNaTAvx2(const long long* src, int len, long long offset, long long* dst){
+	const __m256i nat = _mm256_set1_epi64x(LLONG_MIN);
+	const __m256i off = _mm256_set1_epi64x(offset);
+	__m256i anyNaT = _mm256_setzero_si256();
+	int i = 0;
+	for(; i + 4 <= len; i += 4){
+		__m256i value = _mm256_loadu_si256((const __m256i*)(src + i));
+		__m256i isNaT = _mm256_cmpeq_epi64(value, nat);
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(_mm256_add_epi64(value, off), nat, isNaT));
+		anyNaT = _mm256_or_si256(anyNaT, isNaT);
+	}
+	bool hasNull = translateNaTScalar<long long>(src + i, len - i, offset, LLONG_MIN, dst + i);
+	return hasNull || !_mm256_testz_si256(anyNaT, anyNaT);
+}
+
+__attribute__((target("sse4.1")))
+bool translateNaTSse41(const long long* src, int len, long long offset, long long* dst){
+	const __m128i nat = _mm_set1_epi64x(LLONG_MIN);
+	const __m128i off = _mm_set1_epi64x(offset);
+	__m128i anyNaT = _mm_setzero_si128();
+	int i = 0;
+	for(; i + 2 <= len; i += 2){
+		__m128i value = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i isNaT = _mm_cmpeq_epi64(value, nat);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_blendv_epi8(_mm_add_epi64(value, off), nat, isNaT));
+		anyNaT = _mm_or_si128(anyNaT, isNaT);
+	}
+	bool hasNull = translateNaTScalar<long long>(src + i, len - i, offset, LLONG_MIN, dst + i);
+	return hasNull || !_mm_testz_si128(anyNaT, anyNaT);
+}
+
+//The null value is written as INT_MIN sign extended to 64 bits and the low half of each lane is kept.
+__attribute__((target("avx2")))
+bool translateNaTAvx2(const long long* src, int len, long long offset, int* dst){
+	const __m256i nat = _mm256_set1_epi64x(LLONG_MIN);
+	const __m256i nullVal = _mm256_set1_epi64x(INT_MIN);
+	const __m256i off = _mm256_set1_epi64x(offset);
+	const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	__m256i anyNaT = _mm256_setzero_si256();
+	int i = 0;
+	for(; i + 4 <= len; i += 4){
+		__m256i value = _mm256_loadu_si256((const __m256i*)(src + i));
+		__m256i isNaT = _mm256_cmpeq_epi64(value, nat);
+		__m256i result = _mm256_blendv_epi8(_mm256_add_epi64(value, off), nullVal, isNaT);
+		result = _mm256_permutevar8x32_epi32(result, lowHalves);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm256_castsi256_si128(result));
+		anyNaT = _mm256_or_si256(anyNaT, isNaT);
+	}
+	bool hasNull = translateNaTScalar<int>(src + i, len - i, offset, INT_MIN, dst + i);
+	return hasNull || !_mm256_testz_si256(anyNaT, anyNaT);
+}
+
+__attribute__((target("sse4.1")))
+bool translateNaTSse41(const long long* src, int len, long long offset, int* dst){
+	const __m128i nat = _mm_set1_epi64x(LLONG_MIN);
+	const __m128i nullVal = _mm_set1_epi64x(INT_MIN);
+	const __m128i off = _mm_set1_epi64x(offset);
+	__m128i anyNaT = _mm_setzero_si128();
+	int i = 0;
+	for(; i + 2 <= len; i += 2){
+		__m128i value = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i isNaT = _mm_cmpeq_epi64(value, nat);
+		__m128i result = _mm_blendv_epi8(_mm_add_epi64(value, off), nullVal, isNaT);
+		_mm_storel_epi64((__m128i*)(dst + i), _mm_shuffle_epi32(result, _MM_SHUFFLE(2, 0, 2, 0)));
+		anyNaT = _mm_or_si128(anyNaT, isNaT);
+	}
+	bool hasNull = translateNaTScalar<int>(src + i, len - i, offset, INT_MIN, dst + i);
+	return hasNull || !_mm_testz_si128(anyNaT, anyNaT);
+}
+
+//Masks are NumPy bools, one byte per element. The helpers widen them to the element size and
+//return all ones in the lanes whose mask byte is 0, i.e. the lanes keeping their value.
+__attribute__((target("avx2")))
+inline __m256i keepLanesAvx2(const unsigned char* mask, const char*){
+	__m256i lanes = _mm256_loadu_si256((const __m256i*)mask);
+	return _mm256_cmpeq_epi8(lanes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+inline __m256i keepLanesAvx2(const unsigned char* mask, const short*){
+	__m256i lanes = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)mask));
+	return _mm256_cmpeq_epi16(lanes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+inline __m256i keepLanesAvx2(const unsigned char* mask, const int*){
+	__m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)mask));
+	return _mm256_cmpeq_epi32(lanes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+inline __m256i keepLanesAvx2(const unsigned char* mask, const long long*){
+	int bytes;
+	memcpy(&bytes, mask, sizeof(bytes));
+	__m256i lanes = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+	return _mm256_cmpeq_epi64(lanes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+inline __m256i broadcastAvx2(char value){ return _mm256_set1_epi8(value); }
+__attribute__((target("avx2")))
+inline __m256i broadcastAvx2(short value){ return _mm256_set1_epi16(value); }
+__attribute__((target("avx2")))
+inline __m256i broadcastAvx2(int value){ return _mm256_set1_epi32(value); }
+__attribute__((target("avx2")))
+inline __m256i broadcastAvx2(long long value){ return _mm256_set1_epi64x(value); }
+
+template<typename T>
+__attribute__((target("avx2")))
+bool applyMaskAvx2(const T* src, const unsigned char* mask, int len, T nullVal, T* dst){
+	const int lanes = sizeof(__m256i) / sizeof(T);
+	const __m256i nullVec = broadcastAvx2(nullVal);
+	__m256i allKept = _mm256_set1_epi8(-1);
+	int i = 0;
+	for(; i + lanes <= len; i += lanes){
+		__m256i keep = keepLanesAvx2(mask + i, src);
+		__m256i value = _mm256_loadu_si256((const __m256i*)(src + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(nullVec, value, keep));
+		allKept = _mm256_and_si256(allKept, keep);
+	}
+	bool hasNull = applyMaskScalar(src + i, mask + i, len - i, nullVal, dst + i);
+	return hasNull || _mm256_movemask_epi8(allKept) != -1;
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i keepLanesSse41(const unsigned char* mask, const char*){
+	__m128i lanes = _mm_loadu_si128((const __m128i*)mask);
+	return _mm_cmpeq_epi8(lanes, _mm_setzero_si128());
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i keepLanesSse41(const unsigned char* mask, const short*){
+	__m128i lanes = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)mask));
+	return _mm_cmpeq_epi16(lanes, _mm_setzero_si128());
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i keepLanesSse41(const unsigned char* mask, const int*){
+	int bytes;
+	memcpy(&bytes, mask, sizeof(bytes));
+	__m128i lanes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+	return _mm_cmpeq_epi32(lanes, _mm_setzero_si128());
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i keepLanesSse41(const unsigned char* mask, const long long*){
+	short bytes;
+	memcpy(&bytes, mask, sizeof(bytes));
+	__m128i lanes = _mm_cvtepu8_epi64(_mm_cvtsi32_si128((unsigned short)bytes));
+	return _mm_cmpeq_epi64(lanes, _mm_setzero_si128());
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i broadcastSse41(char value){ return _mm_set1_epi8(value); }
+__attribute__((target("sse4.1")))
+inline __m128i broadcastSse41(short value){ return _mm_set1_epi16(value); }
+__attribute__((target("sse4.1")))
+inline __m128i broadcastSse41(int value){ return _mm_set1_epi32(value); }
+__attribute__((target("sse4.1")))
+inline __m128i broadcastSse41(long long value){ return _mm_set1_epi64x(value); }
+
+template<typename T>
+__attribute__((target("sse4.1")))
+bool applyMaskSse41(const T* src, const unsigned char* mask, int len, T nullVal, T* dst){
+	const int lanes = sizeof(__m128i) / sizeof(T);
+	const __m128i nullVec = broadcastSse41(nullVal);
+	__m128i allKept = _mm_set1_epi8(-1);
+	int i = 0;
+	for(; i + lanes <= len; i += lanes){
+		__m128i keep = keepLanesSse41(mask + i, src);
+		__m128i value = _mm_loadu_si128((const __m128i*)(src + i));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_blendv_epi8(nullVec, value, keep));
+		allKept = _mm_and_si128(allKept, keep);
+	}
+	bool hasNull = applyMaskScalar(src + i, mask + i, len - i, nullVal, dst + i);
+	return hasNull || _mm_movemask_epi8(allKept) != 0xFFFF;
+}
+
+#endif
+
+template<typename T>
+inline bool dispatchApplyMask(const T* src, const unsigned char* mask, int len, T nullVal, T* dst){
+#ifdef NULLKERNEL_X86
+	switch(getSupportedSet()){
+	case IS_AVX2:
+		return applyMaskAvx2(src, mask, len, nullVal, dst);
+	case IS_SSE41:
+		return applyMaskSse41(src, mask, len, nullVal, dst);
+	default:
+		break;
+	}
+#endif
+	return applyMaskScalar(src, mask, len, nullVal, dst);
+}
+
+}
+
+bool NullKernel::translateFloat(const float* src, int len, float* dst){
+#ifdef NULLKERNEL_X86
+	switch(getSupportedSet()){
+	case IS_AVX2:
+		return translateFloatAvx2(src, len, dst);
+	case IS_SSE41:
+		return translateFloatSse41(src, len, dst);
+	default:
+		break;
+	}
+#endif
+	return translateNaNScalar(src, len, FLT_NMIN, dst);
+}
+
+bool NullKernel::translateDouble(const double* src, int len, double* dst){
+#ifdef NULLKERNEL_X86
+	switch(getSupportedSet()){
+	case IS_AVX2:
+		return translateDoubleAvx2(src, len, dst);
+	case IS_SSE41:
+		return translateDoubleSse41(src, len, dst);
+	default:
+		break;
+	}
+#endif
+	return translateNaNScalar(src, len, DBL_NMIN, dst);
+}
+
+bool NullKernel::translateDatetime64(const long long* src, int len, long long offset, long long* dst){
+#ifdef NULLKERNEL_X86
+	switch(getSupportedSet()){
+	case IS_AVX2:
+		return translateNaTAvx2(src, len, offset, dst);
+	case IS_SSE41:
+		return translateNaTSse41(src, len, offset, dst);
+	default:
+		break;
+	}
+#endif
+	return translateNaTScalar<long long>(src, len, offset, LLONG_MIN, dst);
+}
+
+bool NullKernel::translateDatetime64(const long long* src, int len, long long offset, int* dst){
+#ifdef NULLKERNEL_X86
+	switch(getSupportedSet()){
+	case IS_AVX2:
+		return translateNaTAvx2(src, len, offset, dst);
+	case IS_SSE41:
+		return translateNaTSse41(src, len, offset, dst);
+	default:
+		break;
+	}
+#endif
+	return translateNaTScalar<int>(src, len, offset, INT_MIN, dst);
+}
+
+bool NullKernel::applyMask(const char* src, const unsigned char* mask, int len, char nullVal, char* dst){
+	return dispatchApplyMask(src, mask, len, nullVal, dst);
+}
+
+bool NullKernel::applyMask(const short* src, const unsigned char* mask, int len, short nullVal, short* dst){
+	return dispatchApplyMask(src, mask, len, nullVal, dst);
+}
+
+bool NullKernel::applyMask(const int* src, const unsigned char* mask, int len, int nullVal, int* dst){
+	return dispatchApplyMask(src, mask, len, nullVal, dst);
+}
+
+bool NullKernel::applyMask(const long long* src, const unsigned char* mask, int len, long long nullVal, long long* dst){
+	return dispatchApplyMask(src, mask, len, nullVal, dst);
+}
+
+std::string NullKernel::getInstructionSet(){
+	switch(getSupportedSet()){
+	case IS_AVX2:
+		return "avx2";
+	case IS_SSE41:
+		return "sse4.1";
+	default:
+		return "scalar";
+	}
+}
+
+}
@@ -0,0 +1,38 @@
+/*
+ * NullKernel.h
+ *
+ * Kernels translating NumPy/pandas missing values (NaN, NaT, masked elements)
+ * into DolphinDB null values. Every kernel reads the source once, writes the
+ * destination in the same pass and returns true if at least one null was written.
+ * The implementation (AVX2, SSE4.1 or scalar) is chosen at runtime from the CPU.
+ */
+
+#ifndef NULLKERNEL_H_
+#define NULLKERNEL_H_
+
+#include <string>
+
+namespace dolphindb {
+
+class NullKernel {
+public:
+	//NaN -> FLT_NMIN
+	static bool translateFloat(const float* src, int len, float* dst);
+	//NaN -> DBL_NMIN
+	static bool translateDouble(const double* src, int len, double* dst);
+	//NaT -> LLONG_MIN, otherwise src + offset
+	static bool translateDatetime64(const long long* src, int len, long long offset, long long* dst);
+	//NaT -> INT_MIN, otherwise (int)(src + offset). For DATE, MONTH, TIME, DATETIME, etc.
+	static bool translateDatetime64(const long long* src, int len, long long offset, int* dst);
+	//mask[i] != 0 -> nullVal, otherwise src[i]. For pandas nullable arrays (values + mask).
+	static bool applyMask(const char* src, const unsigned char* mask, int len, char nullVal, char* dst);
+	static bool applyMask(const short* src, const unsigned char* mask, int len, short nullVal, short* dst);
+	static bool applyMask(const int* src, const unsigned char* mask, int len, int nullVal, int* dst);
+	static bool applyMask(const long long* src, const unsigned char* mask, int len, long long nullVal, long long* dst);
+	//"avx2", "sse4.1" or "scalar"
+	static std::string getInstructionSet();
+};
+
+}
+
+#endif /* NULLKERNEL_H_ */
@@ -8,12 +8,36 @@
 #include "DolphinDB.h"
 #include "SysIO.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 struct UnpicklerObject;
 namespace dolphindb{
+    //Buffer for the pickle frames that can't be decoded in place. A connection keeps one and lends it to every
+    //PickleUnmarshall reading from its socket, so it grows to the largest frame seen and is then reused.
+    class EXPORT_DECL PickleFrameArena{
+    public:
+        PickleFrameArena() : capacity_(0){}
+        char* reserve(size_t size){
+            if(size > capacity_){
+                buf_.reset(new char[size]);
+                capacity_ = size;
+            }
+            return buf_.get();
+        }
+    private:
+        std::unique_ptr<char[]> buf_;
+        size_t capacity_;
+    };
+
     class EXPORT_DECL PickleUnmarshall{
     public:
-        PickleUnmarshall(const DataInputStreamSP& in);
-        ~PickleUnmarshall(){}
+        //The unpickler is a Python object, create, reset and destroy a PickleUnmarshall with the GIL held.
+        PickleUnmarshall(const DataInputStreamSP& in, PickleFrameArena* arena = NULL);
+        ~PickleUnmarshall();
+        //Read the next object from another stream. Call reset() after each start() before reusing the instance.
+        void setInputStream(const DataInputStreamSP& in, PickleFrameArena* arena = NULL);
         bool start(short flag, bool blocking, IO_ERR& ret);
         void reset();
         PyObject * getPyObj(){ return obj_; }
@@ -73,16 +97,35 @@ namespace dolphindb{
         int load_frame(IO_ERR& ret);
         int load_symbol(IO_ERR& ret, char &lastDoOp);
         int load_objectBegin(IO_ERR& ret);
+        //numpy arrays are pickled as _reconstruct(ndarray, (0,), b'b') followed by BUILD with the state
+        //(version, shape, dtype, is_fortran, rawdata). These create the final array when its rawdata is
+        //read and fill it from the stream, so neither _reconstruct, the bytes object nor __setstate__ is needed.
+        bool is_ndarray_reconstruct(PyObject *callable, PyObject *argtup);
+        PyObject * new_reconstructed_array(size_t size);
+        bool build_reconstructed_array(PyObject *inst, PyObject *state);
+        //the symbols written straight into a list belong on the stack when their MARK is closed by something else than APPENDS
+        int restore_direct_symbols();
     private:
         bool do_opr(char op, IO_ERR &ret);
         bool get_opr(char &op, IO_ERR &ret);
         PyObject * obj_;
         DataInputStreamSP in_;
         UnpicklerObject * unpickler_;
+        PickleFrameArena ownArena_;
+        PickleFrameArena* arena_;
         char* frame_;
         char shortBuf_[8] = {0};
         size_t frameIdx_;
         size_t frameLen_;
+        //empty arrays pushed for _reconstruct and waiting for their BUILD, with the memo index they may be stored at
+        std::vector<std::pair<PyObject*, size_t>> reconstructing_;
+        //the last MARK pushed, if it went directly on top of a list: its depth in the mark stack (0 if not) and the list
+        Py_ssize_t listMarkDepth_;
+        PyObject *listMarkTarget_;
+        //the MARK whose symbols went straight into its list: its depth (0 if none), the list and the list size before
+        Py_ssize_t directDepth_;
+        PyObject *directList_;
+        Py_ssize_t directStart_;
     };
 }; //end of namespace dolphindb
 
@@ -1,6 +1,7 @@
 #include "Python.h"
 #include "Pickle.h"
 #include "structmember.h"
+#include "pybind11/numpy.h"
 #include "ScalarImp.h"
 #include "Util.h"
 
@@ -12,6 +13,8 @@ std::string GetObjectStr(PyObject *obj);
 #define DLOG2(text, param) DLOGPRINT(text,param);
 #define DLOGOP(text, op) DLOGPRINT(text,"pos",GETPOS(),"op",char(op),0xff&op,"stack",Py_SIZE(unpickler_->stack) - unpickler_->stack->fence);
 #define DLOG(text) DLOGPRINT(text);
+//memo entries a reused unpickler keeps allocated between runs
+#define MEMO_KEEP_SIZE 4096
 
 std::string GetObjectStr(PyObject *obj)
 {
@@ -1750,7 +1753,9 @@ calc_binint(char *bytes, int nbytes)
 
 namespace dolphindb
 {
-    PickleUnmarshall::PickleUnmarshall(const DataInputStreamSP &in) : obj_(NULL), in_(in), frame_(nullptr), frameIdx_(0), frameLen_(0)
+    PickleUnmarshall::PickleUnmarshall(const DataInputStreamSP &in, PickleFrameArena *arena) : obj_(NULL), in_(in),
+            arena_(arena != NULL ? arena : &ownArena_), frame_(nullptr), frameIdx_(0), frameLen_(0), listMarkDepth_(0), listMarkTarget_(NULL),
+            directDepth_(0), directList_(NULL), directStart_(0)
     {
         unpickler_ = _Unpickler_New();
         if (unpickler_ == NULL)
@@ -2211,6 +2216,31 @@ namespace dolphindb
             ddb::DLogger::Error("load_counted_binbytes invalid size",size);
             return -1;
         }
+        if (PyObject *array = new_reconstructed_array(size))
+        {
+            char *data = pybind11::detail::array_proxy(array)->data;
+            if (frameLen_ - frameIdx_ < (size_t)size)
+            {
+                size_t actualSize = 0;
+                if ((ret = in_->readBytes(data, size, actualSize)) != OK || actualSize != (size_t)size){
+                    //a truncated stream must not leave the tail of the array uninitialized
+                    if (ret == OK)
+                        ret = END_OF_STREAM;
+                    ddb::DLogger::Error("load_counted_binbytes read array data failed",ret);
+                    Py_DECREF(array);
+                    return -1;
+                }
+            }
+            else
+            {
+                memcpy(data, frame_ + frameIdx_, size);
+                frameIdx_ += size;
+            }
+            PDATA_PUSH(unpickler_->stack, array, -1);
+            return 0;
+        }
+        if (PyErr_Occurred())
+            return -1;
 
         if (frameLen_ - frameIdx_ < size)
         {
@@ -3344,6 +3374,11 @@ namespace dolphindb
         inst = unpickler_->stack->data[Py_SIZE(unpickler_->stack) - 1];
         DLOGOBJ("build on", inst);
         DLOGOBJ("state", state);
+        if (!reconstructing_.empty() && inst == reconstructing_.back().first && build_reconstructed_array(inst, state))
+        {
+            Py_DECREF(state);
+            return 0;
+        }
         if (Ddb_PyObject_LookupAttrId(inst, &PyId___setstate__, &setstate) < 0)
         {
             DLogger::Error("load_build _PyObject_LookupAttrId failed");
@@ -3474,11 +3509,38 @@ namespace dolphindb
             }
             unpickler_->marks_size = (Py_ssize_t)alloc;
         }
-        unpickler_->stack->mark_set = 1;
-        unpickler_->marks[unpickler_->num_marks++] = unpickler_->stack->fence = Py_SIZE(unpickler_->stack);
+        Pdata *stack = unpickler_->stack;
+        Py_ssize_t len = Py_SIZE(stack);
+        //a second MARK at the same position belongs to something else than the list below
+        bool onList = len > 0 && PyList_CheckExact(stack->data[len - 1]) &&
+                      (unpickler_->num_marks == 0 || unpickler_->marks[unpickler_->num_marks - 1] != len);
+        stack->mark_set = 1;
+        unpickler_->marks[unpickler_->num_marks++] = stack->fence = len;
+        listMarkDepth_ = onList ? unpickler_->num_marks : 0;
+        listMarkTarget_ = onList ? stack->data[len - 1] : NULL;
         return 0;
     }
 
+    static bool closes_mark(char op)
+    {
+        switch ((enum Pickle::opcode)op)
+        {
+        case Pickle::opcode::TUPLE:
+        case Pickle::opcode::LIST:
+        case Pickle::opcode::DICT:
+        case Pickle::opcode::ADDITEMS:
+        case Pickle::opcode::FROZENSET:
+        case Pickle::opcode::OBJ:
+        case Pickle::opcode::INST:
+        case Pickle::opcode::POP:
+        case Pickle::opcode::POP_MARK:
+        case Pickle::opcode::SETITEMS:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     int PickleUnmarshall::load_reduce()
     {
         PyObject *callable = NULL;
@@ -3492,7 +3554,18 @@ namespace dolphindb
         {
             DLOGOBJ("reduce call", callable);
             DLOGOBJ("with", argtup);
-            obj = PyObject_CallObject(callable, argtup);
+            if (is_ndarray_reconstruct(callable, argtup))
+            {
+                //what _reconstruct returns, an empty int8 array that BUILD replaces or fills
+                auto &api = pybind11::detail::npy_api::get();
+                Py_intptr_t zero = 0;
+                obj = api.PyArray_NewFromDescr_(api.PyArray_Type_, api.PyArray_DescrFromType_(pybind11::detail::npy_api::NPY_BYTE_),
+                                                1, &zero, NULL, NULL, 0, NULL);
+                if (obj != NULL)
+                    reconstructing_.push_back(std::make_pair(obj, unpickler_->memo_len));
+            }
+            else
+                obj = PyObject_CallObject(callable, argtup);
             Py_DECREF(callable);
         }
         Py_DECREF(argtup);
@@ -3504,6 +3577,95 @@ namespace dolphindb
         return 0;
     }
 
+    bool PickleUnmarshall::is_ndarray_reconstruct(PyObject *callable, PyObject *argtup)
+    {
+        if (!PyCFunction_Check(callable) || strcmp(((PyCFunctionObject *)callable)->m_ml->ml_name, "_reconstruct") != 0)
+            return false;
+        if (!PyTuple_Check(argtup) || PyTuple_GET_SIZE(argtup) != 3)
+            return false;
+        PyObject *shape = PyTuple_GET_ITEM(argtup, 1);
+        PyObject *typecode = PyTuple_GET_ITEM(argtup, 2);
+        if (!PyTuple_Check(shape) || PyTuple_GET_SIZE(shape) != 1 || !PyLong_Check(PyTuple_GET_ITEM(shape, 0)) ||
+            PyLong_AsLong(PyTuple_GET_ITEM(shape, 0)) != 0)
+        {
+            PyErr_Clear();
+            return false;
+        }
+        if (!PyBytes_Check(typecode) || PyBytes_GET_SIZE(typecode) != 1 || PyBytes_AS_STRING(typecode)[0] != 'b')
+            return false;
+        //subclasses of ndarray may define their own __setstate__
+        return PyTuple_GET_ITEM(argtup, 0) == (PyObject *)pybind11::detail::npy_api::get().PyArray_Type_;
+    }
+
+    PyObject * PickleUnmarshall::new_reconstructed_array(size_t size)
+    {
+        //the stack must be ... inst MARK version shape dtype is_fortran, with inst pushed by load_reduce
+        Pdata *stack = unpickler_->stack;
+        Py_ssize_t fence = stack->fence;
+        if (reconstructing_.empty() || fence < 1 || Py_SIZE(stack) - fence != 4 ||
+            stack->data[fence - 1] != reconstructing_.back().first)
+            return NULL;
+        PyObject *version = stack->data[fence];
+        PyObject *shape = stack->data[fence + 1];
+        PyObject *dtype = stack->data[fence + 2];
+        PyObject *fortran = stack->data[fence + 3];
+        auto &api = pybind11::detail::npy_api::get();
+        if (!PyLong_Check(version) || !PyTuple_Check(shape) || !api.PyArrayDescr_Check_(dtype) || !PyBool_Check(fortran))
+            return NULL;
+        //object arrays pickle a list, sub-array and byte swapped types are left to __setstate__
+        const pybind11::detail::PyArrayDescr_Proxy *descr = pybind11::detail::array_descriptor_proxy(dtype);
+        if ((descr->flags & 0x01) != 0 || descr->subarray != NULL ||
+            descr->byteorder == (Util::isLittleEndian() ? '>' : '<'))
+            return NULL;
+        Py_ssize_t ndim = PyTuple_GET_SIZE(shape);
+        std::vector<Py_intptr_t> dims(ndim);
+        size_t count = 1;
+        for (Py_ssize_t i = 0; i < ndim; ++i)
+        {
+            PyObject *dim = PyTuple_GET_ITEM(shape, i);
+            long long len = PyLong_Check(dim) ? PyLong_AsLongLong(dim) : -1;
+            if (len < 0)
+            {
+                PyErr_Clear();
+                return NULL;
+            }
+            dims[i] = (Py_intptr_t)len;
+            count *= (size_t)len;
+        }
+        if (count * descr->elsize != size)
+            return NULL;
+        Py_INCREF(dtype);
+        return api.PyArray_NewFromDescr_(api.PyArray_Type_, dtype, (int)ndim, dims.data(), NULL, NULL,
+                                         fortran == Py_True ? pybind11::detail::npy_api::NPY_ARRAY_F_CONTIGUOUS_ : 0, NULL);
+    }
+
+    bool PickleUnmarshall::build_reconstructed_array(PyObject *inst, PyObject *state)
+    {
+        size_t memoIdx = reconstructing_.back().second;
+        reconstructing_.pop_back();
+        //new_reconstructed_array put the filled array where __setstate__ expects the raw bytes
+        if (!PyTuple_Check(state) || PyTuple_GET_SIZE(state) != 5 ||
+            !pybind11::detail::npy_api::get().PyArray_Check_(PyTuple_GET_ITEM(state, 4)))
+            return false;
+        PyObject *array = PyTuple_GET_ITEM(state, 4);
+        Py_INCREF(array);
+        unpickler_->stack->data[Py_SIZE(unpickler_->stack) - 1] = array;
+        //the empty array is memoized right after REDUCE, if at all; any other reference is the stack's
+        PyObject **memo = unpickler_->memo;
+        for (size_t i = memoIdx; Py_REFCNT(inst) > 1 && i < unpickler_->memo_size + memoIdx; ++i)
+        {
+            size_t idx = i % unpickler_->memo_size;
+            if (memo[idx] == inst)
+            {
+                Py_INCREF(array);
+                memo[idx] = array;
+                Py_DECREF(inst);
+            }
+        }
+        Py_DECREF(inst);
+        return true;
+    }
+
     int PickleUnmarshall::load_proto(IO_ERR &ret)
     {
         if ((ret = in_->readBytes(shortBuf_, 1, false)) != OK)
@@ -3530,24 +3692,23 @@ namespace dolphindb
             DLOG2("load_frame invalid len",frame_len);
             return -1;
         }
-        if (frame_len > frameLen_)
+        //a frame already in the stream buffer is decoded in place, the stream isn't read again before it is used up
+        const char *buffered = in_->skipBufferedBytes(frame_len);
+        if (buffered != NULL)
         {
-            if (frame_)
-            {
-                delete[] frame_;
-            }
-            frame_ = new char[frame_len];
+            frame_ = const_cast<char *>(buffered);
         }
-        size_t begIdx = 0, actualSize = 0;
-        const size_t BUFFSIZE = 4096;
-        while (begIdx < frame_len)
+        else
         {
-            actualSize = std::min(frame_len - begIdx, BUFFSIZE);
-            if ((ret = in_->readBytes(frame_ + begIdx, actualSize, actualSize)) != OK){
+            frame_ = arena_->reserve(frame_len);
+            size_t actualSize = 0;
+            if ((ret = in_->readBytes(frame_, frame_len, actualSize)) != OK || actualSize != (size_t)frame_len)
+            {
+                if (ret == OK)
+                    ret = END_OF_STREAM;
                 DLOG2("load_frame readBytes failed", ret);
                 return -1;
             }
-            begIdx += actualSize;
         }
         frameLen_ = frame_len;
         frameIdx_ = 0;
@@ -3702,11 +3863,52 @@ namespace dolphindb
                 DLOG2("load size",size);
                 PyObject *value;
                 Py_ssize_t idx;
+                //APPENDS would extend the list under the mark with everything pushed after it, so as long as nothing
+                //has been pushed, the symbols can go into that list directly. Only the last MARK pushed is known to sit
+                //directly on its list, any later MARK resets listMarkDepth_.
+                Pdata *stack = unpickler_->stack;
+                if(listMarkDepth_ > 0 && listMarkDepth_ == unpickler_->num_marks && Py_SIZE(stack) == stack->fence &&
+                   stack->data[stack->fence - 1] == listMarkTarget_){
+                    PyListObject *list = (PyListObject *)stack->data[stack->fence - 1];
+                    Py_ssize_t listSize = Py_SIZE(list);
+                    if(list_resize(list, listSize + size / lenByteSize) < 0){
+                        Py_DECREF(pyBytes);
+                        retCode=-1;
+                        break;
+                    }
+                    if(directDepth_ != unpickler_->num_marks){
+                        directDepth_ = unpickler_->num_marks;
+                        directList_ = (PyObject *)list;
+                        directStart_ = listSize;
+                    }
+                    PyObject **items = list->ob_item + listSize;
+                    Py_ssize_t count = 0;
+                    for(size_t i = 0; i + lenByteSize <= (size_t)size; i = i + lenByteSize) {
+                        idx = calc_binsize(pyBytes->ob_sval + i, lenByteSize);
+                        if(idx<0||idx>=(Py_ssize_t)symbolStringArray.size()){
+                            retCode=-1;
+                            DLogger::Error("load_frame invalid index", idx,"size",symbolStringArray.size());
+                            PyErr_Format(PyExc_ValueError, "invalid symbol index %zd, %zu symbols", idx, symbolStringArray.size());
+                            break;
+                        }
+                        value = symbolStringArray[idx];
+                        Py_INCREF(value);
+                        items[count++] = value;
+                    }
+                    Py_DECREF(pyBytes);
+                    if(retCode!=0){
+                        list_resize(list, listSize + count);
+                        break;
+                    }
+                    DLOG2("load size done",size);
+                    continue;
+                }
                 for(size_t i = 0; i < size; i = i + lenByteSize) {
                     idx = calc_binsize(pyBytes->ob_sval + i, lenByteSize);
                     if(idx<0||idx>=symbolStringArray.size()){
                         retCode=-1;
                         DLogger::Error("load_frame invalid index", idx,"size",symbolStringArray.size());
+                        PyErr_Format(PyExc_ValueError, "invalid symbol index %zd, %zu symbols", idx, symbolStringArray.size());
                         break;
                     }
                     value = symbolStringArray[idx];
@@ -3780,8 +3982,37 @@ namespace dolphindb
         DLOGOP("get_opr", op);
         return true;
     }
+    int PickleUnmarshall::restore_direct_symbols()
+    {
+        //move the references back to the stack, right above the mark, as if they had been pushed one by one
+        Pdata *stack = unpickler_->stack;
+        PyListObject *list = (PyListObject *)directList_;
+        Py_ssize_t count = Py_SIZE(list) - directStart_;
+        directDepth_ = 0;
+        if (count <= 0)
+            return 0;
+        while (Py_SIZE(stack) + count > stack->allocated)
+        {
+            if (Pdata_grow(stack) < 0)
+                return -1;
+        }
+        Py_ssize_t fence = stack->fence;
+        memmove(stack->data + fence + count, stack->data + fence, (Py_SIZE(stack) - fence) * sizeof(PyObject *));
+        memcpy(stack->data + fence, list->ob_item + directStart_, count * sizeof(PyObject *));
+        Py_SIZE(stack) += count;
+        return list_resize(list, directStart_);
+    }
+
     bool PickleUnmarshall::do_opr(char op, IO_ERR &ret)
     {
+        if (directDepth_ > 0)
+        {
+            if (unpickler_->num_marks < directDepth_)
+                directDepth_ = 0;
+            else if (unpickler_->num_marks == directDepth_ && op != Pickle::opcode::APPENDS && closes_mark(op) &&
+                     restore_direct_symbols() < 0)
+                return false;
+        }
         switch ((enum Pickle::opcode)op)
         {
         case Pickle::opcode::NONE:
@@ -4104,6 +4335,10 @@ namespace dolphindb
         unpickler_->proto = i;
         if (Py_SIZE(unpickler_->stack))
             Pdata_clear(unpickler_->stack, 0);
+        reconstructing_.clear();
+        listMarkDepth_ = 0;
+        listMarkTarget_ = NULL;
+        directDepth_ = 0;
 
         char op;
         try{
@@ -4139,14 +4374,51 @@ namespace dolphindb
         return true;
     }
 
+    PickleUnmarshall::~PickleUnmarshall()
+    {
+        Unpickler_clear(unpickler_);
+        Py_DECREF(unpickler_);
+    }
+
+    void PickleUnmarshall::setInputStream(const DataInputStreamSP &in, PickleFrameArena *arena)
+    {
+        in_ = in;
+        arena_ = arena != NULL ? arena : &ownArena_;
+    }
+
     void PickleUnmarshall::reset()
     {
-        if (frame_)
+        frame_ = nullptr;
+        frameIdx_ = 0;
+        frameLen_ = 0;
+        obj_ = NULL;
+        reconstructing_.clear();
+        listMarkDepth_ = 0;
+        listMarkTarget_ = NULL;
+        directDepth_ = 0;
+        //drop the objects of the last run but keep the stack, marks and memo allocations for the next one
+        unpickler_->num_marks = 0;
+        unpickler_->stack->mark_set = 0;
+        unpickler_->stack->fence = 0;
+        Pdata_clear(unpickler_->stack, 0);
+        //memo indexes are mostly handed out in order, so stop once memo_len entries are cleared
+        for (size_t i = 0; unpickler_->memo_len > 0 && i < unpickler_->memo_size; ++i)
         {
-            delete[] frame_;
-            frame_ = nullptr;
+            if (unpickler_->memo[i] != NULL)
+            {
+                Py_CLEAR(unpickler_->memo[i]);
+                --unpickler_->memo_len;
+            }
+        }
+        //a huge result may have grown the memo, don't keep all of it around
+        if (unpickler_->memo_size > MEMO_KEEP_SIZE)
+        {
+            PyObject **memo = PyMem_RESIZE(unpickler_->memo, PyObject *, MEMO_KEEP_SIZE);
+            if (memo != NULL)
+            {
+                unpickler_->memo = memo;
+                unpickler_->memo_size = MEMO_KEEP_SIZE;
+            }
         }
-        Unpickler_clear(unpickler_);
-        Py_DECREF(unpickler_);
     }
 };
@@ -13,6 +13,10 @@
 	#include <arpa/inet.h>
 	#include <fcntl.h>
 	#include <error.h>
+	#include <sys/mman.h>
+	#include <sys/uio.h>
+	#include <sys/un.h>
+	#include <sys/stat.h>
 	#define closesocket(s) ::close(s)
 #else
 	#undef UNICODE
@@ -21,6 +25,8 @@
 	#include <ws2tcpip.h>
 #endif
 #include <string.h>
+#include <climits>
+#include <vector>
 #include <iostream>
 
 #include "SysIO.h"
@@ -35,6 +41,8 @@ namespace dolphindb {
 
 #define RECORD_READ(pbytes, bytelen) //Util::writeFile("/tmp/ddb_read.bin", pbytes, bytelen);
 #define RECORD_WRITE(pbytes, bytelen) //Util::writeFile("/tmp/ddb_write.bin", pbytes, bytelen);
+//slices handed to the kernel in one gathered write, the remaining ones go with the next call
+#define MAX_IO_SLICES 16
 
 bool Socket::ENABLE_TCP_NODELAY = true;
 
@@ -99,11 +107,11 @@ bool Socket::isValid(){
 	return handle_ != INVALID_SOCKET;
 }
 
-IO_ERR Socket::read(char* buffer, size_t length, size_t& actualLength, bool msgPeek){
+IO_ERR Socket::read(char* buffer, size_t length, size_t& actualLength, bool msgPeek, bool waitAll){
 	//RecordTime record("Socket.read");
 	if (!enableSSL_) {
 #ifdef WINDOWS
-		actualLength = recv(handle_, buffer, length, msgPeek ? MSG_PEEK : 0);
+		actualLength = recv(handle_, buffer, length, (msgPeek ? MSG_PEEK : 0) | (blocking_ && waitAll ? MSG_WAITALL : 0));
 		RECORD_READ(buffer, actualLength);
 		if (actualLength <= 0) {
 			DLogger::Error("socket read error", actualLength);
@@ -124,7 +132,7 @@ IO_ERR Socket::read(char* buffer, size_t length, size_t& actualLength, bool msgP
 		}
 #else //Linux
 readdata:
-		actualLength = recv(handle_, (void*)buffer, length, (blocking_ ? 0 : MSG_DONTWAIT) | (msgPeek ? MSG_PEEK : 0));
+		actualLength = recv(handle_, (void*)buffer, length, (blocking_ ? (waitAll ? MSG_WAITALL : 0) : MSG_DONTWAIT) | (msgPeek ? MSG_PEEK : 0));
 		RECORD_READ(buffer, actualLength);
 		if (actualLength <= 0) {
 			DLogger::Error("socket read error", actualLength);
@@ -216,6 +224,68 @@ IO_ERR Socket::write(const char* buffer, size_t length, size_t& actualLength){
 	}
 }
 
+IO_ERR Socket::writev(const IoSlice* slices, int count, size_t& actualLength){
+	actualLength = 0;
+	if(enableSSL_){
+		for(int i = 0; i < count; ++i){
+			if(slices[i].length > 0)
+				return write(slices[i].data, slices[i].length, actualLength);
+		}
+		return OK;
+	}
+	count = ((std::min))(count, MAX_IO_SLICES);
+#ifdef WINDOWS
+	WSABUF bufs[MAX_IO_SLICES];
+	for(int i = 0; i < count; ++i){
+		bufs[i].buf = (char*)slices[i].data;
+		bufs[i].len = (ULONG)((std::min))(slices[i].length, (size_t)INT_MAX);
+	}
+	DWORD sent = 0;
+	if(WSASend(handle_, bufs, count, &sent, 0, NULL, NULL) != SOCKET_ERROR){
+		actualLength = sent;
+		return OK;
+	}
+	int error=WSAGetLastError();
+	DLogger::Error("socket write error", error);
+	if(error==WSAENOTCONN || error==WSAESHUTDOWN || error==WSAENETRESET)
+		return DISCONNECTED;
+	else if(error==WSAEWOULDBLOCK || error==WSAENOBUFS)
+		return NOSPACE;
+	else{
+		LOG_ERR("Socket::writev errno =" + std::to_string(error));
+		return OTHERERR;
+	}
+#else
+	struct iovec vecs[MAX_IO_SLICES];
+	for(int i = 0; i < count; ++i){
+		vecs[i].iov_base = (void*)slices[i].data;
+		vecs[i].iov_len = slices[i].length;
+	}
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = vecs;
+	msg.msg_iovlen = count;
+	ssize_t sent;
+	do{
+		sent = sendmsg(handle_, &msg, blocking_ ? MSG_NOSIGNAL : MSG_DONTWAIT|MSG_NOSIGNAL);
+	}while(sent == SOCKET_ERROR && errno == EINTR);
+
+	if(sent != SOCKET_ERROR){
+		actualLength = sent;
+		return OK;
+	}
+	DLogger::Error("socket write error", errno);
+	if(errno==EAGAIN || errno==EWOULDBLOCK)
+		return NOSPACE;
+	else if(errno==ECONNRESET || errno==EPIPE || errno==EBADF || errno==ENOTCONN)
+		return DISCONNECTED;
+	else{
+		LOG_ERR("Socket::writev errno =" + std::to_string(errno));
+		return OTHERERR;
+	}
+#endif
+}
+
 IO_ERR Socket::bind(){
 	if(port_<0 || handle_==INVALID_SOCKET)
 		return OTHERERR;
@@ -262,6 +332,8 @@ IO_ERR Socket::connect(const string& host, int port, bool blocking, int keepAliv
 }
 
 IO_ERR Socket::connect(){
+	if(!unixPath_.empty())
+		return connectUnix(unixPath_, blocking_);
 	if(port_ == -1 || host_.empty())
 		return OTHERERR;
 
@@ -342,6 +414,49 @@ IO_ERR Socket::connect(){
 		return OK;
 }
 
+IO_ERR Socket::connectUnix(const string& path, bool blocking){
+	unixPath_ = path;
+	blocking_ = blocking;
+#ifdef WINDOWS
+	LOG_ERR("Unix domain sockets are not supported on this platform, path = " + path);
+	return OTHERERR;
+#else
+	struct sockaddr_un addr;
+	if(path.size() >= sizeof(addr.sun_path)){
+		LOG_ERR("The unix socket path is too long: " + path);
+		return OTHERERR;
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	memcpy(addr.sun_path, path.c_str(), path.size());
+
+	if((handle_ = socket(AF_UNIX, SOCK_STREAM, 0)) == (SOCKET)SOCKET_ERROR){
+		handle_ = INVALID_SOCKET;
+		LOG_ERR("Couldn't create a unix socket with error code " + std::to_string(getErrorCode()));
+		return OTHERERR;
+	}
+	if(!blocking_ && !setNonBlocking()){
+		closesocket(handle_);
+		handle_ = INVALID_SOCKET;
+		return OTHERERR;
+	}
+	if(::connect(handle_, (struct sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR){
+		if(!blocking_ && errno == EINPROGRESS)
+			return INPROGRESS;
+		LOG_ERR("Failed to connect to unix socket " + path + " with error code " + std::to_string(getErrorCode()));
+		closesocket(handle_);
+		handle_ = INVALID_SOCKET;
+		return DISCONNECTED;
+	}
+	if(!enableSSL_)
+		return OK;
+	else if(sslConnect() != OK)
+		return DISCONNECTED;
+	else
+		return OK;
+#endif
+}
+
 IO_ERR Socket::close(){
 	if(ssl_ != nullptr) {
 		SSL_shutdown(ssl_);
@@ -813,6 +928,15 @@ IO_ERR DataInputStream::readBytes(char* buf, size_t length, bool reverseOrder){
 	return OK;
 }
 
+const char* DataInputStream::skipBufferedBytes(size_t length){
+	if(size_ < length)
+		return NULL;
+	const char* data = buf_ + cursor_;
+	size_ -= length;
+	cursor_ += length;
+	return data;
+}
+
 IO_ERR DataInputStream::readBytes(char* buf, size_t length, size_t& actualLength){
 	actualLength = 0;
     size_t count = ((std::min))(size_, length);
@@ -829,7 +953,8 @@ IO_ERR DataInputStream::readBytes(char* buf, size_t length, size_t& actualLength
     	count = 0;
     	IO_ERR ret = OK;
     	while(ret == OK && actualLength < length){
-    		ret = socket_->read(buf+actualLength, length-actualLength, count);
+    		//the rest goes straight into the caller's buffer, e.g. the storage of a vector
+    		ret = socket_->read(buf+actualLength, length-actualLength, count, false, true);
 			if(ret == OK)
 				actualLength += count;
     	}
@@ -855,8 +980,12 @@ IO_ERR DataInputStream::readBytes(char* buf, size_t length, size_t& actualLength
     }
     else{
     	size_t readCount;
-    	IO_ERR ret = internalStreamRead(buf + actualLength, length - actualLength, readCount);
-   		actualLength += readCount;
+    	IO_ERR ret = OK;
+    	while(ret == OK && actualLength < length){
+    		ret = internalStreamRead(buf + actualLength, length - actualLength, readCount);
+    		if(ret == OK)
+    			actualLength += readCount;
+    	}
     	return ret;
     }
 }
@@ -899,13 +1028,17 @@ IO_ERR DataInputStream::prepareBytes(size_t length){
 	size_t actualLength;
 	size_t usedSpace = cursor_ + size_;
 	if(source_ == SOCKET_STREAM){
+		size_t space = 0;
+		actualLength = 0;
 		while(size_ < length){
-			IO_ERR ret = socket_->read(buf_ + usedSpace, capacity_ - usedSpace, actualLength);
+			space = capacity_ - usedSpace;
+			IO_ERR ret = socket_->read(buf_ + usedSpace, space, actualLength);
 			if(ret != OK)
 				return ret;
 			size_ += actualLength;
 			usedSpace += actualLength;
 		}
+		growSocketBuffer(actualLength, space);
 		return OK;
 	}
 	else if(source_ == FILE_STREAM){
@@ -924,16 +1057,30 @@ IO_ERR DataInputStream::prepareBytes(size_t length){
 			return OTHERERR;
 	}
 	else{
-		IO_ERR ret  = internalStreamRead(buf_ + usedSpace, capacity_ - usedSpace, actualLength);
-		size_ += actualLength;
-		if(size_ < length){
-			return END_OF_STREAM;
+		while(size_ < length){
+			IO_ERR ret  = internalStreamRead(buf_ + usedSpace, capacity_ - usedSpace, actualLength);
+			if(ret != OK)
+				return ret;
+			size_ += actualLength;
+			usedSpace += actualLength;
 		}
-		else
-			return ret;
+		return OK;
 	}
 }
 
+void DataInputStream::growSocketBuffer(size_t readLength, size_t space){
+	//a read that filled all the free space means more data is waiting, so read bigger pieces from now on
+	if(space == 0 || readLength < space || capacity_ >= MAX_SOCKET_BUFFER_SIZE || externalBuf_)
+		return;
+	size_t capacity = ((std::min))(2 * capacity_, (size_t)MAX_SOCKET_BUFFER_SIZE);
+	char* tmp = new char[capacity];
+	memcpy(tmp, buf_ + cursor_, size_);
+	delete[] buf_;
+	buf_ = tmp;
+	capacity_ = capacity;
+	cursor_ = 0;
+}
+
 IO_ERR DataInputStream::prepareBytesEndWith(char endChar, size_t& endPos){
 	size_t searchedSize = 0;
 	bool found = false;
@@ -981,7 +1128,7 @@ IO_ERR DataInputStream::prepareBytesEndWith(char endChar, size_t& endPos){
 				if( ret != OK)
 					return ret;
 				size_ += actualLength;
-				usedSpace += actualLength;
+				growSocketBuffer(actualLength, capacity_ - usedSpace);
 			}
 			else if(source_ == FILE_STREAM){
 				actualLength = fread(buf_ + usedSpace, 1, capacity_ - usedSpace, file_);
@@ -1031,6 +1178,90 @@ IO_ERR DataInputStream::close(){
 	}
 }
 
+MappedFileInputStream::MappedFileInputStream() : DataInputStream(ARRAY_STREAM, 1), mapping_(NULL), fileSize_(0){
+	delete[] buf_;
+	buf_ = NULL;
+	externalBuf_ = true;
+	capacity_ = 0;
+}
+
+MappedFileInputStream::~MappedFileInputStream(){
+	if(mapping_ == NULL)
+		return;
+#ifdef LINUX
+	munmap(mapping_, fileSize_);
+#else
+	UnmapViewOfFile(mapping_);
+#endif
+}
+
+IO_ERR MappedFileInputStream::open(const string& path){
+	if(mapping_ != NULL)
+		return OTHERERR;
+#ifdef LINUX
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		return OTHERERR;
+	struct stat st;
+	if(fstat(fd, &st) != 0){
+		::close(fd);
+		return OTHERERR;
+	}
+	fileSize_ = st.st_size;
+	if(fileSize_ > 0){
+		void* addr = mmap(NULL, fileSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(addr == MAP_FAILED){
+			::close(fd);
+			fileSize_ = 0;
+			return OTHERERR;
+		}
+		mapping_ = (char*)addr;
+		madvise(addr, fileSize_, MADV_SEQUENTIAL);
+	}
+	::close(fd);
+#else
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+		return OTHERERR;
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size)){
+		CloseHandle(file);
+		return OTHERERR;
+	}
+	fileSize_ = size.QuadPart;
+	if(fileSize_ > 0){
+		//the view keeps the mapping object alive after both handles are closed
+		HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		mapping_ = map == NULL ? NULL : (char*)MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+		if(map != NULL)
+			CloseHandle(map);
+		if(mapping_ == NULL){
+			CloseHandle(file);
+			fileSize_ = 0;
+			return OTHERERR;
+		}
+	}
+	CloseHandle(file);
+#endif
+	buf_ = mapping_;
+	capacity_ = fileSize_;
+	size_ = fileSize_;
+	cursor_ = 0;
+	return OK;
+}
+
+void MappedFileInputStream::prefetch() const {
+	if(mapping_ == NULL)
+		return;
+#ifdef LINUX
+	madvise(mapping_, fileSize_, MADV_WILLNEED);
+#endif
+	volatile char sink = 0;
+	for(size_t i = 0; i < fileSize_; i += 4096)
+		sink ^= mapping_[i];
+	(void)sink;
+}
+
 DataOutputStream::DataOutputStream(const SocketSP& socket, size_t flushThreshold) : source_(SOCKET_STREAM),
 		flushThreshold_(flushThreshold), socket_(socket), file_(0), buf_(0), capacity_(flushThreshold * 2), size_(0), autoClose_(false){
 	if(capacity_ > 0)
@@ -1252,6 +1483,47 @@ IO_ERR DataOutputStream::write(const char* buffer, size_t length){
 	}
 }
 
+IO_ERR DataOutputStream::write(const IoSlice* slices, int count){
+	IO_ERR ret = OK;
+	if(source_ != SOCKET_STREAM){
+		size_t actualWritten;
+		for(int i = 0; i < count && ret == OK; ++i){
+			if(slices[i].length > 0)
+				ret = write(slices[i].data, slices[i].length, actualWritten);
+		}
+		return ret;
+	}
+
+	//the cached bytes go first, then the slices; a partial send moves the cursor into the next pending slice
+	std::vector<IoSlice> pending;
+	pending.reserve(count + 1);
+	if(size_ > 0){
+		IoSlice cached = {buf_, size_};
+		pending.push_back(cached);
+	}
+	for(int i = 0; i < count; ++i){
+		if(slices[i].length > 0)
+			pending.push_back(slices[i]);
+	}
+	size_t first = 0;
+	size_t sent = 0;
+	while(first < pending.size()){
+		ret = socket_->writev(pending.data() + first, (int)(pending.size() - first), sent);
+		if(ret != OK)
+			return ret;
+		while(first < pending.size() && sent >= pending[first].length){
+			sent -= pending[first].length;
+			++first;
+		}
+		if(first < pending.size()){
+			pending[first].data += sent;
+			pending[first].length -= sent;
+		}
+	}
+	size_ = 0;
+	return OK;
+}
+
 IO_ERR DataOutputStream::resume(){
 	if(size_ == 0 || source_ != SOCKET_STREAM)
 		return OK;
@@ -17,6 +17,8 @@
 #include "Types.h"
 
 #define MAX_CAPACITY 65536
+//a socket stream's buffer grows up to this size while reads keep filling it
+#define MAX_SOCKET_BUFFER_SIZE (1 << 20)
 #define MAX_PACKET_SIZE 1400
 
 #ifdef LINUX
@@ -52,6 +54,12 @@ typedef SmartPointer<DataInputStream> DataInputStreamSP;
 typedef SmartPointer<DataOutputStream> DataOutputStreamSP;
 typedef SmartPointer<DataStream> DataStreamSP;
 
+//one piece of a gathered write, the memory is owned by the caller
+struct IoSlice {
+	const char* data;
+	size_t length;
+};
+
 class EXPORT_DECL Socket{
 public:
 	Socket();
@@ -60,12 +68,27 @@ public:
 	~Socket();
 	const string& getHost() const {return host_;}
 	int getPort() const {return port_;}
-	IO_ERR read(char* buffer, size_t length, size_t& actualLength, bool msgPeek = false);
+	/**
+	 * With waitAll a blocking plain socket returns only when length bytes arrived, the connection failed or a signal
+	 * interrupted it, so a large block is received with one call instead of one per TCP segment batch.
+	 */
+	IO_ERR read(char* buffer, size_t length, size_t& actualLength, bool msgPeek = false, bool waitAll = false);
 	IO_ERR write(const char* buffer, size_t length, size_t& actualLength);
+	/**
+	 * Sends the slices in order with one system call. actualLength may stop anywhere inside a slice. An SSL socket
+	 * has no gathered write and sends the first non-empty slice only.
+	 */
+	IO_ERR writev(const IoSlice* slices, int count, size_t& actualLength);
 	IO_ERR bind();
 	IO_ERR listen();
 	IO_ERR connect(const string& host, int port, bool blocking, int keepAliveTime, bool enableSSL = false);
 	IO_ERR connect();
+	/**
+	 * Connects to a server on the same host through a Unix domain socket. It skips the TCP stack and its per-message
+	 * overhead; the streams above the socket see no difference. Later calls of connect() reuse the path.
+	 */
+	IO_ERR connectUnix(const string& path, bool blocking);
+	const string& getUnixPath() const {return unixPath_;}
 	IO_ERR sslConnect();
 	IO_ERR close();
 	Socket* accept();
@@ -95,6 +118,7 @@ private:
 	SSL_CTX* ctx_;
 	SSL* ssl_;
 	int keepAliveTime_;
+	string unixPath_;
 };
 
 class EXPORT_DECL UdpSocket{
@@ -164,6 +188,12 @@ public:
 	IO_ERR peekBuffer(char* buf, size_t size);
 	IO_ERR peekLine(string& value);
 
+	/**
+	 * If the next length bytes are already in the internal buffer, skip them and return the address of the first one,
+	 * otherwise return NULL and leave the stream as it is. The data stays valid until the next read from the stream.
+	 */
+	const char* skipBufferedBytes(size_t length);
+
 	inline bool isSocketStream() const {return source_ == SOCKET_STREAM;}
 	inline bool isFileStream() const { return source_ == FILE_STREAM;}
 	inline bool isArrayStream() const {return source_ == ARRAY_STREAM;}
@@ -205,6 +235,7 @@ protected:
 private:
 	IO_ERR prepareBytes(size_t length);
 	IO_ERR prepareBytesEndWith(char endChar, size_t& endPos);
+	void growSocketBuffer(size_t readLength, size_t space);
 
 protected:
 	SocketSP socket_;
@@ -219,6 +250,27 @@ protected:
 	size_t cursor_;
 };
 
+/**
+ * Input stream over a read-only memory mapping of a whole file. The mapped pages are the stream's buffer, so reads
+ * copy straight from the page cache and skipBufferedBytes() returns pointers into the mapping.
+ */
+class EXPORT_DECL MappedFileInputStream : public DataInputStream{
+public:
+	MappedFileInputStream();
+	virtual ~MappedFileInputStream();
+	IO_ERR open(const string& path);
+	const char* getData() const { return mapping_;}
+	size_t getFileSize() const { return fileSize_;}
+	/**
+	 * Fault the mapped pages in, so that a later parse on another thread doesn't wait on the disk.
+	 */
+	void prefetch() const;
+
+private:
+	char* mapping_;
+	size_t fileSize_;
+};
+
 class EXPORT_DECL DataOutputStream {
 public:
 	DataOutputStream(const SocketSP& socket, size_t flushThreshold = 4096);
@@ -228,6 +280,11 @@ public:
 	virtual ~DataOutputStream();
 	IO_ERR write(const char* buffer, size_t length, size_t& actualWritten);
 	IO_ERR write(const char* buffer, size_t length);
+	/**
+	 * Writes the cached bytes and the slices to a socket without copying the slices into the stream buffer.
+	 * It blocks until everything is sent. Other streams write the slices one after another.
+	 */
+	IO_ERR write(const IoSlice* slices, int count);
 	IO_ERR resume();
 	inline IO_ERR start(const char* buffer, size_t length){return write(buffer, length);}
 	inline IO_ERR write(const string& buffer){ return write(buffer.c_str(), buffer.length() + 1);}
@@ -7,6 +7,6 @@ from .session import tableAppender
 from .session import BatchTableWriter
 from .session import MultithreadedTableWriter
 from .table import *
-from .vector import Vector
+from .vector import Vector, ArrayVector
 from .database import Database
 from .month import month
@@ -35,8 +35,8 @@ using std::endl;
 class DBConnectionPoolImpl {
 public:
     DBConnectionPoolImpl(const std::string& hostName, int port, int threadNum = 10, const std::string& userId = "", const std::string& password = "",
-            bool loadBalance = false, bool highAvailability = false, bool reConnectFlag = true,bool compress = false, bool enablePickle = true)
-            :dbConnectionPool_(hostName, port, threadNum, userId, password,loadBalance,highAvailability,reConnectFlag,compress,enablePickle),
+            bool loadBalance = false, bool highAvailability = false, bool reConnectFlag = true,bool compress = false, bool enablePickle = true, int eventLoopThreads = 0)
+            :dbConnectionPool_(hostName, port, threadNum, userId, password,loadBalance,highAvailability,reConnectFlag,compress,enablePickle,eventLoopThreads),
                 host_(hostName), port_(port), threadNum_(threadNum), userId_(userId), password_(password) {}
     ~DBConnectionPoolImpl() {}
     py::object run(const string &script, int taskId) {
@@ -68,8 +68,20 @@ public:
         if(kwargs.contains("pickleTableToList")){
             pickleTableToList = kwargs["pickleTableToList"].cast<bool>();
         }
+        bool nullableDtype = false;
+        if(kwargs.contains("nullableDtype")){
+            nullableDtype = kwargs["nullableDtype"].cast<bool>();
+        }
+        bool symbolAsCategory = false;
+        if(kwargs.contains("symbolAsCategory")){
+            symbolAsCategory = kwargs["symbolAsCategory"].cast<bool>();
+        }
+        bool pipelinedDecode = false;
+        if(kwargs.contains("pipelinedDecode")){
+            pipelinedDecode = kwargs["pipelinedDecode"].cast<bool>();
+        }
         try {
-            dbConnectionPool_.runPy(script, taskId, 4, 2, 0, clearMemory, pickleTableToList);
+            dbConnectionPool_.runPy(script, taskId, 4, 2, 0, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
         } catch (ddb::RuntimeException &ex) { throw std::runtime_error(std::string("<Exception> in run: ") + ex.what()); }
         //ddb::DLogger::Info(script,"cost time\n",ddb::RecordTime::printAllTime());
         return py::none();
@@ -84,10 +96,22 @@ public:
         if(kwargs.contains("pickleTableToList")){
             pickleTableToList = kwargs["pickleTableToList"].cast<bool>();
         }
+        bool nullableDtype = false;
+        if(kwargs.contains("nullableDtype")){
+            nullableDtype = kwargs["nullableDtype"].cast<bool>();
+        }
+        bool symbolAsCategory = false;
+        if(kwargs.contains("symbolAsCategory")){
+            symbolAsCategory = kwargs["symbolAsCategory"].cast<bool>();
+        }
+        bool pipelinedDecode = false;
+        if(kwargs.contains("pipelinedDecode")){
+            pipelinedDecode = kwargs["pipelinedDecode"].cast<bool>();
+        }
         vector<ddb::ConstantSP> ddbArgs;
         for (auto it = args.begin(); it != args.end(); ++it) { ddbArgs.push_back(ddb::DdbPythonUtil::toDolphinDB(py::reinterpret_borrow<py::object>(*it))); }
         try {
-            dbConnectionPool_.runPy(funcName, ddbArgs, taskId, 4, 2, 0, clearMemory,pickleTableToList);
+            dbConnectionPool_.runPy(funcName, ddbArgs, taskId, 4, 2, 0, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
         } catch (ddb::RuntimeException &ex) { throw std::runtime_error(std::string("<Exception> in call: ") + ex.what()); }
         return py::none();
     }
@@ -159,6 +183,25 @@ private:
     ddb::BlockReaderSP reader_;
 };
 
+//Result of run(..., output="arrow"). Implements the Arrow PyCapsule interface,
+//so pyarrow or any other consumer imports it without copying the fixed-width columns.
+class ArrowData{
+public:
+    ArrowData(ddb::ConstantSP data): data_(data){
+    }
+    py::tuple arrowCArray(py::object requestedSchema){
+        try {
+            return ddb::DdbPythonUtil::toArrow(data_);
+        }catch (ddb::RuntimeException &ex) { throw std::runtime_error(std::string("<Exception> in __arrow_c_array__: ") + ex.what()); }
+    }
+    bool isTable(){
+        return data_->isTable();
+    }
+
+private:
+    ddb::ConstantSP data_;
+};
+
 class PartitionedTableAppender{
 public:
     PartitionedTableAppender(string dbUrl, string tableName, string partitionColName, DBConnectionPoolImpl& pool)
@@ -184,7 +227,7 @@ public:
             dbConnection_(enableSSL,enableASYN, keepAliveTime, compress, enablePickle), nullValuePolicy_([](ddb::VectorSP) {}), subscriber_(nullptr),subscriberPool_(nullptr),keepAliveTime_(keepAliveTime) {}
 
     bool connect(const std::string &host, const int &port, const std::string &userId, const std::string &password, const std::string &startup = "", const bool &highAvailability = false,
-                 const py::list &highAvailabilitySites = py::list(0), const int &keepAliveTime=30) {
+                 const py::list &highAvailabilitySites = py::list(0), const int &keepAliveTime=30, const std::string &unixSocket = "") {
         host_ = host;
         port_ = port;
         userId_ = userId;
@@ -196,7 +239,7 @@ public:
         try {
             vector<string> sites;
             for (py::handle o : highAvailabilitySites) { sites.emplace_back(py::cast<std::string>(o)); }
-            isSuccess = dbConnection_.connect(host_, port_, userId_, password_, startup, highAvailability, sites);
+            isSuccess = dbConnection_.connect(host_, port_, userId_, password_, startup, highAvailability, sites, unixSocket);
         } catch (ddb::RuntimeException &ex) { throw std::runtime_error(std::string("<Exception> in connect: ") + ex.what()); }
         return isSuccess;
     }
@@ -234,6 +277,12 @@ public:
     py::object loadPickleFile(const std::string &filepath){
         return ddb::DdbPythonUtil::loadPickleFile(filepath);
     }
+    py::list loadPickleFiles(const py::list &filepaths){
+        vector<string> paths;
+        for (py::handle path : filepaths)
+            paths.push_back(path.cast<std::string>());
+        return ddb::DdbPythonUtil::loadPickleFiles(paths);
+    }
     py::object upload(const py::dict &namedObjects) {
         vector<std::string> names;
         vector<ddb::ConstantSP> objs;
@@ -294,10 +343,25 @@ public:
         if(kwargs.contains("pickleTableToList")){
             pickleTableToList = kwargs["pickleTableToList"].cast<bool>();
         }
+        bool nullableDtype = false;
+        if(kwargs.contains("nullableDtype")){
+            nullableDtype = kwargs["nullableDtype"].cast<bool>();
+        }
+        bool symbolAsCategory = false;
+        if(kwargs.contains("symbolAsCategory")){
+            symbolAsCategory = kwargs["symbolAsCategory"].cast<bool>();
+        }
+        bool pipelinedDecode = false;
+        if(kwargs.contains("pipelinedDecode")){
+            pipelinedDecode = kwargs["pipelinedDecode"].cast<bool>();
+        }
         py::object result;
         try {
+            if(isArrowOutput(kwargs)){
+                return py::cast(ArrowData(dbConnection_.run(script, 4, 2, 0, clearMemory)));
+            }
             //ddb::RecordTime::printAllTime();
-            result = dbConnection_.runPy(script, 4, 2, 0, clearMemory, pickleTableToList);
+            result = dbConnection_.runPy(script, 4, 2, 0, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
             DLOG(ddb::RecordTime::printAllTime());
         } catch (ddb::RuntimeException &ex) { throw std::runtime_error(std::string("<Exception> in run: ") + ex.what()); }
         return result;
@@ -312,17 +376,66 @@ public:
         if(kwargs.contains("pickleTableToList")){
             pickleTableToList = kwargs["pickleTableToList"].cast<bool>();
         }
+        bool nullableDtype = false;
+        if(kwargs.contains("nullableDtype")){
+            nullableDtype = kwargs["nullableDtype"].cast<bool>();
+        }
+        bool symbolAsCategory = false;
+        if(kwargs.contains("symbolAsCategory")){
+            symbolAsCategory = kwargs["symbolAsCategory"].cast<bool>();
+        }
+        bool pipelinedDecode = false;
+        if(kwargs.contains("pipelinedDecode")){
+            pipelinedDecode = kwargs["pipelinedDecode"].cast<bool>();
+        }
         py::object result;
         //ddb::RecordTime::printAllTime();
         try {
             vector<ddb::ConstantSP> ddbArgs;
             for (auto it = args.begin(); it != args.end(); ++it) { ddbArgs.push_back(ddb::DdbPythonUtil::toDolphinDB(py::reinterpret_borrow<py::object>(*it))); }
-            result = dbConnection_.runPy(funcName, ddbArgs, 4, 2, 0, clearMemory,pickleTableToList);
+            if(isArrowOutput(kwargs)){
+                return py::cast(ArrowData(dbConnection_.run(funcName, ddbArgs, 4, 2, 0, clearMemory)));
+            }
+            result = dbConnection_.runPy(funcName, ddbArgs, 4, 2, 0, clearMemory,pickleTableToList, nullableDtype, symbolAsCategory, pipelinedDecode);
         } catch (ddb::RuntimeException &ex) { throw std::runtime_error(std::string("<Exception> in call: ") + ex.what()); }
         DLOG(ddb::RecordTime::printAllTime());
         return result;
     }
 
+    static bool isArrowOutput(const py::kwargs &kwargs) {
+        if(!kwargs.contains("output"))
+            return false;
+        std::string output = kwargs["output"].cast<std::string>();
+        if(output != "arrow")
+            throw std::runtime_error("<Exception> in run: unsupported output '" + output + "', only 'arrow' is supported.");
+        return true;
+    }
+
+    py::list runPipelined(const py::list &scripts, const py::kwargs & kwargs) {
+        vector<string> scriptList;
+        for (py::handle script : scripts)
+            scriptList.push_back(script.cast<std::string>());
+        bool clearMemory = false;
+        if(kwargs.contains("clearMemory")){
+            clearMemory = kwargs["clearMemory"].cast<bool>();
+        }
+        bool pickleTableToList = false;
+        if(kwargs.contains("pickleTableToList")){
+            pickleTableToList = kwargs["pickleTableToList"].cast<bool>();
+        }
+        bool nullableDtype = false;
+        if(kwargs.contains("nullableDtype")){
+            nullableDtype = kwargs["nullableDtype"].cast<bool>();
+        }
+        bool symbolAsCategory = false;
+        if(kwargs.contains("symbolAsCategory")){
+            symbolAsCategory = kwargs["symbolAsCategory"].cast<bool>();
+        }
+        try {
+            return dbConnection_.runPyPipelined(scriptList, 4, 2, clearMemory, pickleTableToList, nullableDtype, symbolAsCategory);
+        } catch (ddb::RuntimeException &ex) { throw std::runtime_error(std::string("<Exception> in runPipelined: ") + ex.what()); }
+    }
+
     BlockReader runBlock(const string &script, const py::kwargs & kwargs) {
         int fetchSize = 0;
         bool clearMemory = false;
@@ -700,6 +813,45 @@ public:
         //ddb::g_OutputDestroyMsg=false;
         return errorinfo;
     }
+    //Insert rows given column by column. Each column is converted in one pass and the writer gets them
+    //whole, after the rows still waiting in the row pool. An array vector column may be a
+    //dolphindb.ArrayVector, a 2-D numpy array or a list of rows.
+    py::dict insertColumns(const py::args &columns){
+        if(writer_->isExit()){
+            throw std::runtime_error(std::string("<Exception> in insertColumns: thread is exiting."));
+        }
+        py::dict errorinfo;
+        int colSize = writer_->getColSize();
+        if((int)columns.size() != colSize){
+            errorinfo["errorCode"] = ddb::ErrorCodeInfo::formatApiCode(ddb::ErrorCodeInfo::EC_InvalidParameter);
+            errorinfo["errorInfo"] = std::string("Column counts don't match ") + std::to_string(colSize);
+            return errorinfo;
+        }
+        const ddb::DATA_TYPE *colTypes = writer_->getColType();
+        std::vector<ddb::ConstantSP> ddbColumns;
+        try {
+            for(int i = 0; i < colSize; i++){
+                ddbColumns.push_back(ddb::DdbPythonUtil::toDolphinDB(py::reinterpret_borrow<py::object>(columns[i]), ddb::DF_VECTOR, colTypes[i]));
+            }
+        } catch (ddb::RuntimeException &ex) {
+            errorinfo["errorCode"] = ddb::ErrorCodeInfo::formatApiCode(ddb::ErrorCodeInfo::EC_InvalidObject);
+            errorinfo["errorInfo"] = std::string(ex.what());
+            return errorinfo;
+        }
+        int rows = ddbColumns[0]->size();
+        for(int i = 1; i < colSize; i++){
+            if(ddbColumns[i]->size() != rows){
+                errorinfo["errorCode"] = ddb::ErrorCodeInfo::formatApiCode(ddb::ErrorCodeInfo::EC_InvalidParameter);
+                errorinfo["errorInfo"] = std::string("Column sizes don't match ") + std::to_string(rows);
+                return errorinfo;
+            }
+        }
+        if(writer_->getPytoDdb()->insertColumns(ddbColumns) == false){
+            throw std::runtime_error(std::string("<Exception> in insertColumns: thread is exiting."));
+        }
+        errorinfo["errorCode"] = "";
+        return errorinfo;
+    }
     py::dict insertUnwrittenData(const py::list &records){
         if(writer_->isExit()){
             throw std::runtime_error(std::string("<Exception> in insert: thread is exiting."));
@@ -762,7 +914,7 @@ PYBIND11_MODULE(dolphindbcpp, m) {
     m.doc() = R"pbdoc(dolphindbcpp: this is a C++ boosted DolphinDB Python API)pbdoc";
 
     py::class_<DBConnectionPoolImpl>(m, "dbConnectionPoolImpl")
-        .def(py::init<const std::string &,int,int,const std::string &,const std::string &,bool, bool, bool, bool, bool>())
+        .def(py::init<const std::string &,int,int,const std::string &,const std::string &,bool, bool, bool, bool, bool, int>())
         .def("run", (py::object(DBConnectionPoolImpl::*)(const std::string &, int)) & DBConnectionPoolImpl::run)
         .def("run", (py::object(DBConnectionPoolImpl::*)(const std::string &, int, const py::args &)) & DBConnectionPoolImpl::run)
         .def("run", (py::object(DBConnectionPoolImpl::*)(const std::string &, int, const py::kwargs &)) & DBConnectionPoolImpl::run)
@@ -785,6 +937,7 @@ PYBIND11_MODULE(dolphindbcpp, m) {
         .def("run", (py::object(SessionImpl::*)(const std::string &, const py::kwargs &)) & SessionImpl::run)
         .def("run", (py::object(SessionImpl::*)(const std::string &, const py::args &, const py::kwargs &)) & SessionImpl::run)
         .def("runBlock",&SessionImpl::runBlock)
+        .def("runPipelined", &SessionImpl::runPipelined)
         .def("upload", &SessionImpl::upload)
         .def("nullValueToZero", &SessionImpl::nullValueToZero)
         .def("nullValueToNan", &SessionImpl::nullValueToNan)
@@ -794,7 +947,8 @@ PYBIND11_MODULE(dolphindbcpp, m) {
         .def("unsubscribe", &SessionImpl::unsubscribe)
         .def("hashBucket", &SessionImpl::hashBucket)
         .def("getSubscriptionTopics", &SessionImpl::getSubscriptionTopics)
-        .def("loadPickleFile", &SessionImpl::loadPickleFile);
+        .def("loadPickleFile", &SessionImpl::loadPickleFile)
+        .def("loadPickleFiles", &SessionImpl::loadPickleFiles);
     
     py::class_<BlockReader>(m, "blockReader")
         .def(py::init<ddb::BlockReaderSP>())
@@ -802,6 +956,10 @@ PYBIND11_MODULE(dolphindbcpp, m) {
         .def("skipAll", &BlockReader::skipAll)
         .def("hasNext", (py::bool_(BlockReader::*)())&BlockReader::hasNext);
 
+    py::class_<ArrowData>(m, "arrowData")
+        .def("__arrow_c_array__", &ArrowData::arrowCArray, py::arg("requested_schema") = py::none())
+        .def("isTable", &ArrowData::isTable);
+
     py::class_<PartitionedTableAppender>(m, "partitionedTableAppender")
         .def(py::init<const std::string &,const std::string &,const std::string &,DBConnectionPoolImpl&>())
         .def("append", &PartitionedTableAppender::append);
@@ -824,6 +982,7 @@ PYBIND11_MODULE(dolphindbcpp, m) {
         .def("getStatus", &MultithreadedTableWriter::getStatus)
         .def("getUnwrittenData", &MultithreadedTableWriter::getUnwrittenData)
         .def("insert", &MultithreadedTableWriter::insert)
+        .def("insertColumns", &MultithreadedTableWriter::insertColumns)
         .def("insertUnwrittenData", &MultithreadedTableWriter::insertUnwrittenData)
         .def("waitForThreadCompletion", &MultithreadedTableWriter::waitForThreadCompletion);
 
@@ -25,13 +25,27 @@ def _generate_tablename():
 def _generate_dbname():
     return "TMP_DB_" + uuid.uuid4().hex[:8]+"DB"
 
+def _arrow_result(data):
+    """Convert the result of run(..., output="arrow") to a pyarrow Table or Array.
+    Without pyarrow the raw object is returned; it implements the Arrow PyCapsule
+    interface (__arrow_c_array__), so other Arrow libraries can import it as well.
+    """
+    try:
+        import pyarrow as pa
+    except ImportError:
+        return data
+    if data.isTable():
+        return pa.Table.from_batches([pa.record_batch(data)])
+    return pa.array(data)
+
+
 def start_thread_loop(loop):
     asyncio.set_event_loop(loop)
     loop.run_forever()
 
 class DBConnectionPool(object):
-    def __init__(self, host, port, threadNum=10, userid="", password="", loadBalance=False, highAvailability=False, reConnectFlag=True,compress=False,enablePickle=True):
-        self.pool = ddbcpp.dbConnectionPoolImpl(host, port, threadNum, userid, password, loadBalance, highAvailability, reConnectFlag,compress,enablePickle)
+    def __init__(self, host, port, threadNum=10, userid="", password="", loadBalance=False, highAvailability=False, reConnectFlag=True,compress=False,enablePickle=True,eventLoopThreads=0):
+        self.pool = ddbcpp.dbConnectionPoolImpl(host, port, threadNum, userid, password, loadBalance, highAvailability, reConnectFlag,compress,enablePickle,eventLoopThreads)
         self.host = host
         self.port = port
         self.userid = userid
@@ -126,12 +140,14 @@ class session(object):
         if self.host is not None and self.port is not None:
             self.connect(host, port, userid, password)
 
-    def connect(self, host, port, userid="", password="", startup="", highAvailability=False, highAvailabilitySites=None, keepAliveTime=None):
+    def connect(self, host, port, userid="", password="", startup="", highAvailability=False, highAvailabilitySites=None, keepAliveTime=None, unixSocket=None):
         if highAvailabilitySites is None:
             highAvailabilitySites = []
         if keepAliveTime is None:
             keepAliveTime = -1
-        return self.cpp.connect(host, port, userid, password, startup, highAvailability, highAvailabilitySites, keepAliveTime)
+        if unixSocket is None:
+            unixSocket = ""
+        return self.cpp.connect(host, port, userid, password, startup, highAvailability, highAvailabilitySites, keepAliveTime, unixSocket)
 
     def login(self,userid, password, enableEncryption=True):
         self.mutex.acquire()
@@ -158,8 +174,18 @@ class session(object):
         if(kwargs):
             if "fetchSize" in kwargs.keys():
                 return BlockReader(self.cpp.runBlock(script, **kwargs))
+            if "output" in kwargs.keys():
+                return _arrow_result(self.cpp.run(script, *args, **kwargs))
         return self.cpp.run(script, *args, **kwargs)
     
+    def runPipelined(self, scripts, **kwargs):
+        """
+        Run several scripts with their requests sent back to back instead of one round trip each
+        :param scripts: the scripts to run in order
+        :return: a list with the result of each script
+        """
+        return self.cpp.runPipelined(list(scripts), **kwargs)
+
     def runFile(self, filepath, *args, **kwargs):
         with open(filepath, "r") as fp:
             script = fp.read()
@@ -506,6 +532,14 @@ class session(object):
     
     def loadPickleFile(self, filePath):
         return self.cpp.loadPickleFile(filePath)
+
+    def loadPickleFiles(self, filePaths):
+        """
+        Load a list of pickle files, the files are read from disk in parallel
+        :param filePaths: the paths of the pickle files
+        :return: a list with the loaded object or the error status of each file
+        """
+        return self.cpp.loadPickleFiles(list(filePaths))
     
 
 class BlockReader(object):
@@ -649,6 +683,11 @@ class MultithreadedTableWriter(object):
         errorCodeInfo=ErrorCodeInfo()
         errorCodeInfo.__dict__.update(self.writer.insert(*args))
         return errorCodeInfo
+    def insertColumns(self, *columns):
+        """Insert rows given column by column, e.g. an ArrayVector or a 2-D numpy array for an array vector column."""
+        errorCodeInfo=ErrorCodeInfo()
+        errorCodeInfo.__dict__.update(self.writer.insertColumns(*columns))
+        return errorCodeInfo
     def insertUnwrittenData(self, unwrittenData):
         errorCodeInfo=ErrorCodeInfo()
         errorCodeInfo.__dict__.update(self.writer.insertUnwrittenData(unwrittenData))
@@ -1,3 +1,4 @@
+import numpy as np
 from pandas import Series
 
 
@@ -127,3 +128,30 @@ class FilterCond(object):
 
     def __floordiv__(self, other):
         return FilterCond('int(', str(self), ')')
+
+
+class ArrayVector(object):
+    """Rows of a DolphinDB array vector, converted in one pass instead of cell by cell.
+
+    ArrayVector(values) takes a 2-D numpy array, each row becomes one row of the array vector.
+    ArrayVector(values, offsets) takes the flat values of all rows and the end offset of each row,
+    as arrayVector(index, value) in DolphinDB script: ArrayVector([1, 2, 3, 4, 5], [2, 5]) is [[1, 2], [3, 4, 5]].
+
+    It can be uploaded with session.upload and used as a column in MultithreadedTableWriter.insertColumns.
+    """
+    def __init__(self, values, offsets=None):
+        values = np.asarray(values)
+        if offsets is None:
+            if values.ndim != 2:
+                raise ValueError("values must be a 2-D numpy array if offsets is not given")
+            offsets = np.arange(1, values.shape[0] + 1, dtype=np.int64) * values.shape[1]
+            values = values.reshape(-1)
+        else:
+            offsets = np.asarray(offsets)
+        if values.ndim != 1 or offsets.ndim != 1:
+            raise ValueError("values and offsets must be 1-D")
+        self.values = values
+        self.offsets = offsets
+
+    def __len__(self):
+        return len(self.offsets)
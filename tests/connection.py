@@ -1,5 +1,7 @@
+import asyncio
 import unittest
 import dolphindb as ddb
+from standin import StandInServer
 
 
 class MainTest(unittest.TestCase):
@@ -15,5 +17,60 @@ class MainTest(unittest.TestCase):
         r = sess.run("sum", array)
         print(r)
 
+    def test_run_pipelined(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        self.assertEqual(sess.runPipelined(['1 + 1', 'x = 3', 'x * 2']), [2, None, 6])
+        self.assertEqual(sess.run('x'), 3)
+
+    def test_run_pipelined_error(self):
+        # the scripts after a failing one still run and the connection stays usable
+        server = StandInServer()
+        try:
+            sess = ddb.session()
+            sess.connect('127.0.0.1', server.port, 'admin', '123456')
+            with self.assertRaises(RuntimeError):
+                sess.runPipelined(['1 + 1', 'error()', '1 + 1'])
+            self.assertEqual(sess.runPipelined(['1 + 1'] * 100), [2] * 100)
+            sess.close()
+        finally:
+            server.close()
+
+    def test_connect_unix_socket(self):
+        server = StandInServer(StandInServer.temp_path())
+        try:
+            sess = ddb.session()
+            self.assertTrue(sess.connect('localhost', 0, 'admin', '123456', unixSocket=server.path))
+            self.assertEqual(sess.run('1 + 1'), 2)
+            sess.close()
+        finally:
+            server.close()
+
+    def test_pool_event_loop(self):
+        server = StandInServer()
+        try:
+            pool = ddb.DBConnectionPool('127.0.0.1', server.port, 16, 'admin', '123456', eventLoopThreads=2)
+
+            async def runAll():
+                return await asyncio.gather(*[pool.run('1 + 1') for _ in range(100)])
+            self.assertEqual(asyncio.run(runAll()), [2] * 100)
+            pool.shutDown()
+        finally:
+            server.close()
+
+    def test_pool_event_loop_lost_connection(self):
+        # the stand-in drops the connection of each 'drop' script once, the pool reconnects and runs the task again
+        server = StandInServer()
+        try:
+            pool = ddb.DBConnectionPool('127.0.0.1', server.port, 4, 'admin', '123456', eventLoopThreads=2)
+            scripts = ['1 + 1'] * 20 + ['drop({})'.format(i) for i in range(4)] + ['1 + 1'] * 20
+
+            async def runAll():
+                return await asyncio.gather(*[pool.run(script) for script in scripts])
+            self.assertEqual(asyncio.run(runAll()), [2] * len(scripts))
+            pool.shutDown()
+        finally:
+            server.close()
+
 if __name__ == '__main__':
     unittest.main()
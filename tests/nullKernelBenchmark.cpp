@@ -0,0 +1,159 @@
+/*
+ * nullKernelBenchmark.cpp
+ *
+ * Times the NullKernel translation against the per-chunk copy loop AddVectorData used before
+ * and against a plain scalar loop, and checks every kernel result. pandas nullable columns
+ * had no chunked path, they went through object arrays, so they are compared with the scalar loop only.
+ * Build and run from the repository root:
+ *
+ *   g++ -O3 -std=c++11 -IpickleAPI/src tests/nullKernelBenchmark.cpp pickleAPI/src/NullKernel.cpp -o nullKernelBenchmark
+ *   ./nullKernelBenchmark
+ */
+
+#include "NullKernel.h"
+#include "Types.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace dolphindb;
+
+static const int ROWS = 10000000;
+
+//The loop AddVectorData ran before NullKernel: copy 1024 elements to a stack buffer, test them and append.
+template <typename T>
+void processData(T *psrcData, int size, std::function<void(T *, int)> f) {
+	int bufsize = std::min(1024, size);
+	T buf[bufsize];
+	int startIndex = 0, len;
+	while(startIndex < size){
+		len = std::min(size-startIndex, bufsize);
+		memcpy(buf, psrcData+startIndex, sizeof(T)*len);
+		f(buf,len);
+		startIndex += len;
+	}
+}
+
+template <typename T>
+void chunkedCopy(T* src, int len, T nullVal, T* dst){
+	processData<T>(src, len, [&](T* buf, int size) {
+		for(int i = 0; i < size; ++i){
+			if(buf[i] != buf[i])
+				buf[i] = nullVal;
+		}
+		memcpy(dst, buf, sizeof(T) * size);
+		dst += size;
+	});
+}
+
+//datetime64 columns were copied as they are, NaT already being LLONG_MIN, months with 23640 added to every value
+static void chunkedOffset(long long* src, int len, long long offset, long long* dst){
+	processData<long long>(src, len, [&](long long* buf, int size) {
+		for(int i = 0; i < size; ++i)
+			buf[i] += offset;
+		memcpy(dst, buf, sizeof(long long) * size);
+		dst += size;
+	});
+}
+
+static double best(const std::function<void()>& func){
+	double cost = 1e9;
+	for(int i = 0; i < 5; ++i){
+		auto start = std::chrono::steady_clock::now();
+		func();
+		cost = std::min(cost, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+	return cost;
+}
+
+template <typename T>
+static void check(const char* name, const std::vector<T>& result, const std::vector<T>& expected){
+	if(memcmp(result.data(), expected.data(), sizeof(T) * expected.size()) != 0){
+		printf("%s: result differs from the scalar loop\n", name);
+		exit(1);
+	}
+}
+
+static void report(const char* name, double old, double scalar, double cost){
+	if(old < 0)
+		printf("%-10s chunked copy       -, scalar %7.2fms, NullKernel %7.2fms\n", name, scalar, cost);
+	else
+		printf("%-10s chunked copy %7.2fms, scalar %7.2fms, NullKernel %7.2fms\n", name, old, scalar, cost);
+}
+
+template <typename T>
+static void benchMask(const char* name, T nullVal, const std::vector<unsigned char>& mask){
+	std::vector<T> src(ROWS), dst(ROWS), expected(ROWS);
+	for(int i = 0; i < ROWS; ++i)
+		src[i] = (T)i;
+	double scalar = best([&]{
+		for(int i = 0; i < ROWS; ++i)
+			expected[i] = mask[i] ? nullVal : src[i];
+	});
+	double cost = best([&]{ NullKernel::applyMask(src.data(), mask.data(), ROWS, nullVal, dst.data()); });
+	check(name, dst, expected);
+	report(name, -1, scalar, cost);
+}
+
+int main(){
+	printf("instruction set: %s, %d rows, every 100th value null\n", NullKernel::getInstructionSet().c_str(), ROWS);
+	std::vector<unsigned char> mask(ROWS);
+	std::vector<double> d(ROWS), dDst(ROWS), dExpected(ROWS);
+	std::vector<float> f(ROWS), fDst(ROWS), fExpected(ROWS);
+	std::vector<long long> ts(ROWS), tsDst(ROWS), tsExpected(ROWS);
+	std::vector<int> month(ROWS), monthExpected(ROWS);
+	for(int i = 0; i < ROWS; ++i){
+		bool null = i % 100 == 0;
+		mask[i] = null;
+		d[i] = null ? NAN : i * 0.5;
+		f[i] = (float)d[i];
+		ts[i] = null ? LLONG_MIN : i;
+	}
+
+	double old = best([&]{ chunkedCopy(d.data(), ROWS, DBL_NMIN, dDst.data()); });
+	double scalar = best([&]{
+		for(int i = 0; i < ROWS; ++i)
+			dExpected[i] = d[i] != d[i] ? DBL_NMIN : d[i];
+	});
+	double cost = best([&]{ NullKernel::translateDouble(d.data(), ROWS, dDst.data()); });
+	check("double", dDst, dExpected);
+	report("double", old, scalar, cost);
+
+	old = best([&]{ chunkedCopy(f.data(), ROWS, FLT_NMIN, fDst.data()); });
+	scalar = best([&]{
+		for(int i = 0; i < ROWS; ++i)
+			fExpected[i] = f[i] != f[i] ? FLT_NMIN : f[i];
+	});
+	cost = best([&]{ NullKernel::translateFloat(f.data(), ROWS, fDst.data()); });
+	check("float", fDst, fExpected);
+	report("float", old, scalar, cost);
+
+	old = best([&]{ chunkedOffset(ts.data(), ROWS, 0, tsDst.data()); });
+	scalar = best([&]{
+		for(int i = 0; i < ROWS; ++i)
+			tsExpected[i] = ts[i] == LLONG_MIN ? LLONG_MIN : ts[i];
+	});
+	cost = best([&]{ NullKernel::translateDatetime64(ts.data(), ROWS, 0, tsDst.data()); });
+	check("timestamp", tsDst, tsExpected);
+	report("timestamp", old, scalar, cost);
+
+	old = best([&]{ chunkedOffset(ts.data(), ROWS, 23640, tsDst.data()); });
+	scalar = best([&]{
+		for(int i = 0; i < ROWS; ++i)
+			monthExpected[i] = ts[i] == LLONG_MIN ? INT_MIN : (int)(ts[i] + 23640);
+	});
+	cost = best([&]{ NullKernel::translateDatetime64(ts.data(), ROWS, 23640, month.data()); });
+	check("month", month, monthExpected);
+	report("month", old, scalar, cost);
+
+	benchMask<char>("bool/char", CHAR_MIN, mask);
+	benchMask<short>("short", SHRT_MIN, mask);
+	benchMask<int>("int", INT_MIN, mask);
+	benchMask<long long>("long", LLONG_MIN, mask);
+	return 0;
+}
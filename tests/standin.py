@@ -0,0 +1,105 @@
+import os
+import queue
+import socket
+import struct
+import tempfile
+import threading
+import time
+
+
+class StandInServer(object):
+    """Answers every script with the int scalar 2, enough to time the transport without a DolphinDB server.
+
+    A script containing 'error' gets an error response instead. The first time a script containing 'drop' arrives,
+    the server closes that connection without answering, the same script is answered on later connections.
+
+    It listens on a Unix domain socket when path is given, otherwise on a loopback TCP port. With a delay every
+    response leaves that many seconds after its request arrived, like on a link with that round trip time.
+    """
+
+    def __init__(self, path=None, delay=0):
+        if path is None:
+            self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            self.sock.bind(('127.0.0.1', 0))
+            self.port = self.sock.getsockname()[1]
+        else:
+            if os.path.exists(path):
+                os.remove(path)
+            self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            self.sock.bind(path)
+            self.port = 0
+        self.path = path
+        self.delay = delay
+        self.dropped = set()
+        self.lock = threading.Lock()
+        self.sock.listen(8)
+        threading.Thread(target=self._accept, daemon=True).start()
+
+    @staticmethod
+    def temp_path():
+        return os.path.join(tempfile.mkdtemp(), 'ddb.sock')
+
+    def close(self):
+        self.sock.close()
+        if self.path is not None and os.path.exists(self.path):
+            os.remove(self.path)
+
+    def _accept(self):
+        while True:
+            try:
+                conn, _ = self.sock.accept()
+            except OSError:
+                return
+            threading.Thread(target=self._serve, args=(conn,), daemon=True).start()
+
+    def _serve(self, conn):
+        stream = conn.makefile('rb')
+        replies = queue.Queue()
+        sender = threading.Thread(target=self._send, args=(conn, replies), daemon=True)
+        sender.start()
+        with conn:
+            while True:
+                try:
+                    header = stream.readline()
+                except OSError:
+                    break
+                if not header:
+                    break
+                # API <sessionId> <body length> / <flags>
+                body = stream.read(int(header.split()[2]))
+                if body.startswith(b'connect'):
+                    if b'login' in body:
+                        reply = b'1 1 1\nOK\n' + struct.pack('<hb', 1, 1)
+                    else:
+                        reply = b'1 0 1\nOK\n'
+                elif b'error' in body:
+                    reply = b'1 0 1\nstand-in error\n'
+                elif b'drop' in body and self._drop(body):
+                    conn.shutdown(socket.SHUT_RDWR)
+                    break
+                else:
+                    reply = b'1 1 1\nOK\n' + struct.pack('<hi', 4, 2)
+                replies.put((time.monotonic() + self.delay, reply))
+            replies.put((0, None))
+            sender.join()
+
+    def _drop(self, body):
+        with self.lock:
+            if body in self.dropped:
+                return False
+            self.dropped.add(body)
+            return True
+
+    @staticmethod
+    def _send(conn, replies):
+        while True:
+            due, reply = replies.get()
+            if reply is None:
+                return
+            wait = due - time.monotonic()
+            if wait > 0:
+                time.sleep(wait)
+            try:
+                conn.sendall(reply)
+            except OSError:
+                return
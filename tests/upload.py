@@ -3,6 +3,11 @@ import dolphindb as ddb
 import pandas as pd
 import numpy as np
 
+try:
+    import pyarrow as pa
+except ImportError:
+    pa = None
+
 
 class MainTest(unittest.TestCase):
     def test_upload(self):
@@ -17,5 +22,350 @@ class MainTest(unittest.TestCase):
         df = pd.read_pickle('./x.pickle')
         sess.upload({'t1': df})
 
+    def test_upload_numpy_buffer(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        n = 1000000
+        df = pd.DataFrame({'i': np.arange(n, dtype=np.int32), 'l': np.arange(n, dtype=np.int64), 'd': np.linspace(0, 1, n)})
+        sess.upload({'t2': df})
+        self.assertEqual(sess.run('exec sum(i) from t2'), df['i'].sum())
+        self.assertEqual(sess.run('exec sum(l) from t2'), df['l'].sum())
+        self.assertAlmostEqual(sess.run('exec sum(d) from t2'), df['d'].sum())
+        # non-contiguous views are copied, not borrowed
+        sess.upload({'v': df['l'].values[::2]})
+        self.assertEqual(sess.run('size(v)'), n // 2)
+
+    def test_upload_null_values(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        df = pd.DataFrame({'f': np.float32([1.5, np.nan, 3]), 'd': [np.nan, 2.5, 3.5],
+                           'ts': np.array(['2022-01-01T00:00:00', 'NaT', '2022-01-03T00:00:00'], dtype='datetime64[ns]'),
+                           'm': np.array(['2022-01', 'NaT', '2022-03'], dtype='datetime64[M]'),
+                           'i': pd.array([1, None, 3], dtype='Int32'), 'l': pd.array([None, 2, 3], dtype='Int64'),
+                           'b': pd.array([True, None, False], dtype='boolean')})
+        sess.upload({'t3': df})
+        self.assertEqual(sess.run('select count(*) from t3 where isNull(f)')['count'][0], 1)
+        self.assertEqual(sess.run('exec isNull(d) from t3').tolist(), [True, False, False])
+        self.assertEqual(sess.run('exec isNull(ts) from t3').tolist(), [False, True, False])
+        self.assertEqual(sess.run('exec isNull(m) from t3').tolist(), [False, True, False])
+        self.assertEqual(sess.run('exec isNull(i) from t3').tolist(), [False, True, False])
+        self.assertEqual(sess.run('exec isNull(l) from t3').tolist(), [True, False, False])
+        self.assertEqual(sess.run('exec isNull(b) from t3').tolist(), [False, True, False])
+        self.assertEqual(sess.run('typestr(t3.i)'), 'FAST INT VECTOR')
+
+    def test_upload_strings(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        s = np.array(['abc', None, '\u4e2d\u6587', np.nan, 'x' * 5000], dtype='object')
+        sess.upload({'s': s, 't4': pd.DataFrame({'s': s})})
+        self.assertEqual(sess.run('s').tolist(), ['abc', '', '\u4e2d\u6587', '', 'x' * 5000])
+        self.assertEqual(sess.run('exec isNull(s) from t4').tolist(), [False, True, False, True, False])
+        self.assertEqual(sess.run('exec strlen(s) from t4').tolist(), [3, 0, 6, 0, 5000])
+
+    def test_upload_categorical(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        df = pd.DataFrame({'sym': pd.Categorical(['IBM', 'MSFT', None, 'IBM', 'GOOG'])})
+        sess.upload({'t5': df})
+        self.assertEqual(sess.run('typestr(t5.sym)'), 'FAST SYMBOL VECTOR')
+        self.assertEqual(sess.run('exec sym from t5').tolist(), ['IBM', 'MSFT', '', 'IBM', 'GOOG'])
+        self.assertEqual(sess.run('exec isNull(sym) from t5').tolist(), [False, False, True, False, False])
+
+    def test_upload_categorical_all_missing(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        df = pd.DataFrame({'sym': pd.Categorical([np.nan] * 3), 'v': [1, 2, 3]})
+        sess.upload({'t5': df})
+        self.assertEqual(sess.run('typestr(t5.sym)'), 'FAST SYMBOL VECTOR')
+        self.assertEqual(sess.run('exec isNull(sym) from t5').tolist(), [True, True, True])
+        self.assertEqual(sess.run('exec sum(v) from t5'), 6)
+
+    def test_upload_same_schema(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        # the second frame has the same schema, but its object column is no longer all strings
+        s = ['a'] * 1000
+        sess.upload({'t6': pd.DataFrame({'s': s, 'v': np.arange(1000)})})
+        self.assertEqual(sess.run('typestr(t6.s)'), 'STRING VECTOR')
+        s[999] = 1
+        sess.upload({'t6': pd.DataFrame({'s': s, 'v': np.arange(1000)})})
+        self.assertEqual(sess.run('typestr(t6.s)'), 'ANY VECTOR')
+        self.assertEqual(sess.run('t6.s[999]'), 1)
+
+    @unittest.skipIf(pa is None, 'pyarrow is not installed')
+    def test_upload_arrow(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        tbl = pa.table({'i': pa.array([1, None, 3], pa.int32()),
+                        'd': pa.array([1.5, 2.5, None]),
+                        's': pa.array(['a', None, 'c']),
+                        'c': pa.array(['x', 'y', 'x']).dictionary_encode(),
+                        'ts': pa.array([0, 1000, None], pa.timestamp('ms')),
+                        'l': pa.array([[1.0], [], [2.0, 3.0]])})
+        sess.upload({'t7': tbl})
+        self.assertEqual(sess.run('typestr(t7.c)'), 'FAST SYMBOL VECTOR')
+        self.assertEqual(sess.run('typestr(t7.l)'), 'FAST DOUBLE[] VECTOR')
+        self.assertEqual(sess.run('exec sum(isNull(i)) + sum(isNull(d)) + sum(isNull(s)) + sum(isNull(ts)) from t7'), 4)
+        sess.upload({'v7': pa.chunked_array([[1, 2], [3]], pa.int64())})
+        self.assertEqual(sess.run('sum(v7)'), 6)
+
+    @unittest.skipIf(pa is None, 'pyarrow is not installed')
+    def test_upload_arrow_null_list(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        # a null list becomes a row with one null value, an empty list stays empty
+        sess.upload({'t7': pa.table({'l': pa.array([[1.0, 2.0], None, [], [3.0]])})})
+        self.assertEqual(sess.run('exec size(l) from t7').tolist(), [2, 1, 0, 1])
+        self.assertEqual(sess.run('isNull(flatten(t7.l))').tolist(), [False, False, True, False])
+        self.assertEqual(sess.run('sum(flatten(t7.l))'), 6.0)
+
+    @unittest.skipIf(pa is None, 'pyarrow is not installed')
+    def test_run_arrow(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        tbl = sess.run("table(1..3 as i, [1.5, NULL, 3.5] as d, `a`b`c as s, symbol(`x`y`x) as c, 2012.01M + 0..2 as m, arrayVector(1 3, 1 2 3) as l)", output='arrow')
+        self.assertEqual(tbl.column_names, ['i', 'd', 's', 'c', 'm', 'l'])
+        self.assertEqual(tbl.column('d').null_count, 1)
+        self.assertEqual(tbl.column('c').to_pylist(), ['x', 'y', 'x'])
+        self.assertEqual(str(tbl.column('m')[1]), '2012-02-01')
+        self.assertEqual(tbl.column('l').to_pylist(), [[1], [2, 3]])
+        self.assertEqual(sess.run('1..5', output='arrow').to_pylist(), [1, 2, 3, 4, 5])
+
+    def test_upload_array_vector(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        sess.upload({'av1': ddb.ArrayVector(np.arange(6, dtype=np.float64).reshape(3, 2))})
+        self.assertEqual(sess.run('typestr(av1)'), 'FAST DOUBLE[] VECTOR')
+        self.assertEqual(sess.run('av1[2]').tolist(), [4.0, 5.0])
+        sess.upload({'av2': ddb.ArrayVector(np.array([1, 2, 3, 4, 5], dtype=np.int32), [2, 2, 5])})
+        self.assertEqual(sess.run('rows(av2)'), 3)
+        self.assertEqual(sess.run('size(av2[1])'), 0)
+        # a column of ndarray rows is concatenated with numpy instead of being converted cell by cell
+        df = pd.DataFrame({'id': np.arange(3), 'bid': list(np.arange(30, dtype=np.float64).reshape(3, 10))})
+        sess.upload({'t8': df})
+        self.assertEqual(sess.run('typestr(t8.bid)'), 'FAST DOUBLE[] VECTOR')
+        self.assertEqual(sess.run('exec sum(bid) from t8').tolist(), [45.0, 145.0, 245.0])
+        with self.assertRaises(RuntimeError):
+            sess.upload({'av3': ddb.ArrayVector([1, 2, 3], [2, 4])})
+
+    def test_append_array_vector_units(self):
+        # datetime64 rows of another unit are rescaled to the column type, not reinterpreted
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        sess.run("share table(100:0, `id`d`ts, [INT, DATE[], TIMESTAMP[]]) as avUnits")
+        appender = ddb.tableAppender(tableName='avUnits', ddbSession=sess)
+        df = pd.DataFrame({'id': np.int32([1, 2]),
+                           'd': [np.array(['2012-01-01T10:00:00', 'NaT'], dtype='datetime64[ms]'), np.array(['2012-01-02'], dtype='datetime64[ms]')],
+                           'ts': [np.array(['2012-01-01T10:00:00.001'], dtype='datetime64[ns]'), np.array(['NaT', '2012-01-02'], dtype='datetime64[ns]')]})
+        self.assertEqual(appender.append(df), 2)
+        self.assertEqual(sess.run('exec string(flatten(d)) from avUnits').tolist(), ['2012.01.01', '', '2012.01.02'])
+        self.assertEqual(sess.run('exec string(flatten(ts)) from avUnits').tolist(), ['2012.01.01T10:00:00.001', '', '2012.01.02T00:00:00.000'])
+        sess.run("undef(`avUnits, SHARED)")
+
+    def test_mtw_insert_columns_order(self):
+        # columns inserted after single rows are written after them, not ahead of the rows still being converted
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        sess.run("share table(100:0, `id`av, [INT, INT[]]) as mtwOrder")
+        writer = ddb.MultithreadedTableWriter('localhost', 9921, 'admin', '123456', 'mtwOrder', '', False, batchSize=1000, throttle=0.1)
+        ids = []
+        for start in range(0, 300, 30):
+            for i in range(start, start + 10):
+                writer.insert(i, [i, -i])
+            self.assertEqual(writer.insertColumns(np.arange(start + 10, start + 30, dtype=np.int32),
+                                                  np.arange(start + 10, start + 30).repeat(2).reshape(20, 2)).errorCode, None)
+            ids += list(range(start, start + 30))
+        writer.waitForThreadCompletion()
+        self.assertEqual(writer.getStatus().sentRows, 300)
+        self.assertEqual(sess.run('exec id from mtwOrder').tolist(), ids)
+        self.assertEqual(sess.run('exec first(av) from mtwOrder').tolist(), ids)
+        sess.run("undef(`mtwOrder, SHARED)")
+
+    def test_run_nullable_dtype(self):
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        script = "table(1 NULL 3 as i, [NULL, 9007199254740993l, 3l] as l, [true, NULL, false] as b, 1h 2h 3h as h)"
+        df = sess.run(script)
+        self.assertEqual(df['i'].dtype, np.float64)
+        self.assertTrue(np.isnan(df['i'][1]))
+        self.assertEqual(df['h'].dtype, np.int16)
+        df = sess.run(script, nullableDtype=True)
+        self.assertEqual(str(df['i'].dtype), 'Int32')
+        self.assertEqual(str(df['l'].dtype), 'Int64')
+        self.assertEqual(str(df['b'].dtype), 'boolean')
+        self.assertEqual(str(df['h'].dtype), 'Int16')
+        self.assertTrue(df['i'].isna()[1])
+        self.assertEqual(df['l'][1], 9007199254740993)
+        self.assertEqual(sess.run("1 NULL 3", nullableDtype=True).tolist(), [1, pd.NA, 3])
+
+    def test_run_zero_copy(self):
+        sess = ddb.session(enablePickle=False)
+        sess.connect('localhost', 9921, 'admin', '123456')
+        v = sess.run('1..1000000')
+        # the array borrows the DolphinDB vector instead of owning a copy
+        self.assertFalse(v.flags.owndata)
+        self.assertEqual(v.sum(), 500000500000)
+        df = sess.run('table(1..5 as i, 1.5 2.5 3.5 4.5 5.5 as d, 2022.01.01T00:00:00.000000001 + 0..4 as ts)')
+        self.assertEqual(df['d'].sum(), 17.5)
+        self.assertEqual(str(df['ts'].dtype), 'datetime64[ns]')
+        mat = sess.run('1..6$2:3')
+        self.assertEqual(mat[0].tolist(), [[1, 3, 5], [2, 4, 6]])
+        self.assertEqual(sess.run('arrayVector(2 4, 1 2 3 4)', pickleTableToList=True).tolist(), [[1, 2], [3, 4]])
+
+    def test_run_pickle_array(self):
+        # the pickle path builds numpy arrays from the raw bytes, the result must match the native protocol
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        native = ddb.session(enablePickle=False)
+        native.connect('localhost', 9921, 'admin', '123456')
+        for script in ('1..100000', '1.5 NULL 3.5', 'take(true false, 7)', '1..6$2:3', 'table(1..1000 as i, 0.5 * (1..1000) as d)',
+                       'symbol(take(`a`b``c, 100000))', 'table(symbol(take(`x`y, 1000)) as s, 1..1000 as i)'):
+            sess.run('x = ' + script)
+            native.run('x = ' + script)
+            a, b = sess.run('x'), native.run('x')
+            if isinstance(b, pd.DataFrame):
+                pd.testing.assert_frame_equal(a, b)
+            elif isinstance(b, list):
+                np.testing.assert_array_equal(a[0], b[0])
+            else:
+                np.testing.assert_array_equal(a, b)
+                self.assertEqual(a.dtype, b.dtype)
+
+    def test_run_pipelined_decode(self):
+        # results larger than the read-ahead ring make the reader thread wait for the unpickler
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        sess.run('t = table(1..3000000 as i, rand(1.0, 3000000) as d, take(`a`b`c, 3000000) as s)')
+        for script in ('t', '1..10', 'exec d from t'):
+            a, b = sess.run(script, pipelinedDecode=True), sess.run(script)
+            if isinstance(b, pd.DataFrame):
+                pd.testing.assert_frame_equal(a, b)
+            else:
+                np.testing.assert_array_equal(a, b)
+        # the connection stays usable after a pipelined run
+        self.assertEqual(sess.run('1 + 1', pipelinedDecode=True), 2)
+
+    def test_load_pickle_files(self):
+        import os, pickle, tempfile
+        sess = ddb.session()
+        objs = [np.arange(1000000), {'a': [1, 'x'], 'b': np.random.rand(10)}]
+        paths = []
+        with tempfile.TemporaryDirectory() as d:
+            for i, obj in enumerate(objs):
+                paths.append(os.path.join(d, '{}.pkl'.format(i)))
+                with open(paths[-1], 'wb') as f:
+                    # anything in front of the pickle header is skipped
+                    f.write(b'junk' + pickle.dumps(obj, protocol=4))
+            np.testing.assert_array_equal(sess.loadPickleFile(paths[0]), objs[0])
+            res = sess.loadPickleFiles(paths + [os.path.join(d, 'missing.pkl')])
+            np.testing.assert_array_equal(res[0], objs[0])
+            self.assertEqual(res[1]['a'], objs[1]['a'])
+            self.assertEqual(res[2]['errorCode'], -1)
+            # the file is read in place, no stripped copy is left next to it
+            self.assertEqual(sorted(os.listdir(d)), ['0.pkl', '1.pkl'])
+
+    def test_load_truncated_pickle(self):
+        import os, pickle, tempfile
+        sess = ddb.session()
+        data = pickle.dumps(np.arange(1000000), protocol=4)
+        with tempfile.TemporaryDirectory() as d:
+            path = os.path.join(d, 'truncated.pkl')
+            with open(path, 'wb') as f:
+                # cut in the middle of the array data
+                f.write(data[:len(data) // 2])
+            self.assertNotEqual(sess.loadPickleFile(path)['errorCode'], 0)
+            self.assertNotEqual(sess.loadPickleFiles([path])[0]['errorCode'], 0)
+
+    def test_load_empty_pickle(self):
+        import os, pickle, tempfile
+        sess = ddb.session()
+        with tempfile.TemporaryDirectory() as d:
+            empty = os.path.join(d, 'empty.pkl')
+            open(empty, 'wb').close()
+            path = os.path.join(d, 'list.pkl')
+            with open(path, 'wb') as f:
+                f.write(pickle.dumps([1, 2, 3], protocol=4))
+            self.assertNotEqual(sess.loadPickleFile(empty)['errorCode'], 0)
+            results = sess.loadPickleFiles([empty, path, empty])
+            self.assertNotEqual(results[0]['errorCode'], 0)
+            self.assertEqual(results[1], [1, 2, 3])
+            self.assertNotEqual(results[2]['errorCode'], 0)
+
+    def test_load_pickle_symbol_nested(self):
+        import os, struct, tempfile
+        sess = ddb.session()
+        # the SYMBOL opcode (0xf1) of the server: its strings, then the ids as 4-byte ints
+        symbols = b'\xf1' + b'\x8c\x00' + b'\x8c\x02s1' + b'\x8c\x02s2' + b'B' + struct.pack('<5i', 16, 1, 2, 0, 1)
+        values = ['s1', 's2', '', 's1']
+        cases = [
+            (b']((' + symbols + b'te', [tuple(values)]),
+            (b'](](' + symbols + b'le', [[], values]),
+            (b'](](' + symbols + b'ee', [values]),
+            (b'](' + symbols + b'e', values),
+        ]
+        with tempfile.TemporaryDirectory() as d:
+            path = os.path.join(d, 'symbol.pkl')
+            for body, expected in cases:
+                with open(path, 'wb') as f:
+                    f.write(b'\x80\x04' + body + b'.')
+                self.assertEqual(sess.loadPickleFile(path), expected)
+
+    def test_run_pickle_reuse(self):
+        # the connection reuses one unpickler, nothing may leak from one result into the next
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        for i in range(200):
+            self.assertEqual(sess.run('{} + 1'.format(i)), i + 1)
+            df = sess.run('table({0} + 1..3 as i, `a`b`c as s)'.format(i))
+            self.assertEqual(df['i'].tolist(), [i + 1, i + 2, i + 3])
+            self.assertEqual(df['s'].tolist(), ['a', 'b', 'c'])
+            self.assertEqual(sess.run('`x`y`x').tolist(), ['x', 'y', 'x'])
+
+    def test_run_symbol(self):
+        sess = ddb.session(enablePickle=False)
+        sess.connect('localhost', 9921, 'admin', '123456')
+        v = sess.run("symbol(`a`b`a`c`a)")
+        self.assertEqual(v.tolist(), ['a', 'b', 'a', 'c', 'a'])
+        # rows with the same symbol share one str object
+        self.assertIs(v[0], v[2])
+        df = sess.run("table(symbol(`x`y`x``y) as s, 1..5 as i)", symbolAsCategory=True)
+        self.assertEqual(str(df['s'].dtype), 'category')
+        self.assertEqual(df['s'].cat.categories.tolist(), ['x', 'y'])
+        self.assertTrue(df['s'].isna()[3])
+        self.assertEqual(df['s'][4], 'y')
+
+    def test_run_temporal(self):
+        sess = ddb.session(enablePickle=False)
+        sess.connect('localhost', 9921, 'admin', '123456')
+        df = sess.run("table([2012.01.01, NULL] as d, [1969.12M, NULL] as m, [13:30:10.008, NULL] as t, [13:30m, NULL] as mi, [13:30:10, NULL] as s, [2012.01.01T13:30:10, NULL] as dt, [2012.01.01T13:30:10.008, NULL] as ts, [2012.01.01T13, NULL] as dh)")
+        for name in df.columns:
+            self.assertEqual(str(df[name].dtype), 'datetime64[ns]')
+            self.assertTrue(pd.isnull(df[name][1]))
+        self.assertEqual(df['d'][0], pd.Timestamp('2012-01-01'))
+        self.assertEqual(df['m'][0], pd.Timestamp('1969-12-01'))
+        self.assertEqual(df['t'][0], pd.Timestamp('1970-01-01 13:30:10.008'))
+        self.assertEqual(df['dh'][0], pd.Timestamp('2012-01-01 13:00:00'))
+        v = sess.run("[2012.01M, NULL]")
+        self.assertEqual(v.dtype, np.dtype('datetime64[M]'))
+        self.assertEqual(v[0], np.datetime64('2012-01'))
+        self.assertTrue(np.isnat(v[1]))
+        self.assertEqual(sess.run("[2012.01.01, NULL]").dtype, np.dtype('datetime64[D]'))
+
+    def test_partitioned_append_strings(self):
+        # the appender hashes the packed string column to route each row to its partition
+        sess = ddb.session()
+        sess.connect('localhost', 9921, 'admin', '123456')
+        df = pd.DataFrame({'sym': np.array(['a', 'bc', 'def', 'a', 'def'] * 20, dtype='object'), 'x': np.arange(100, dtype=np.int32)})
+        for scheme in ['HASH, [STRING, 3]', 'VALUE, `a`bc`def']:
+            sess.run("""dbPath = "dfs://appendStrings"
+                if(existsDatabase(dbPath)) dropDatabase(dbPath)
+                db = database(dbPath, {})
+                db.createPartitionedTable(table(100:0, `sym`x, [STRING, INT]), `pt, `sym)""".format(scheme))
+            pool = ddb.DBConnectionPool('localhost', 9921, 4, 'admin', '123456')
+            appender = ddb.PartitionedTableAppender('dfs://appendStrings', 'pt', 'sym', pool)
+            self.assertEqual(appender.append(df), len(df))
+            self.assertEqual(sess.run('exec count(*) from loadTable("dfs://appendStrings", `pt)'), len(df))
+            pool.shutDown()
+
 if __name__ == '__main__':
     unittest.main()
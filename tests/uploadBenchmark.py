@@ -0,0 +1,223 @@
+import asyncio
+import time
+import unittest
+import dolphindb as ddb
+import pandas as pd
+import numpy as np
+from standin import StandInServer
+
+try:
+    import pyarrow as pa
+except ImportError:
+    pa = None
+
+
+def timeit(func, repeat=5):
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        func()
+        cost = time.perf_counter() - start
+        best = cost if best is None else min(best, cost)
+    return best
+
+
+class UploadBenchmark(unittest.TestCase):
+    rows = 10000000
+
+    def setUp(self):
+        self.sess = ddb.session()
+        self.sess.connect('localhost', 9921, 'admin', '123456')
+
+    def test_null_translation(self):
+        # every 100th value is NaN/NaT, so the null translation kernels run on the whole column
+        # tests/nullKernelBenchmark.cpp times the kernels alone against the old per-chunk copy loop
+        d = np.random.rand(self.rows)
+        d[::100] = np.nan
+        ts = np.arange(self.rows, dtype='datetime64[ns]')
+        ts[::100] = np.datetime64('NaT')
+        df = pd.DataFrame({'d': d, 'f': d.astype(np.float32), 'ts': ts, 'l': pd.array(np.arange(self.rows), dtype='Int64')})
+        df.loc[::100, 'l'] = None
+        for name in df.columns:
+            cost = timeit(lambda: self.sess.upload({'t': df[[name]]}))
+            print('upload {} rows with nulls, column {}: {:.3f}s'.format(self.rows, name, cost))
+        self.assertEqual(self.sess.run('exec sum(isNull(l)) from t'), self.rows // 100)
+
+    def test_upload_numeric(self):
+        # fixed-width columns are sent from the vector memory with one gathered write per column
+        df = pd.DataFrame({'i': np.arange(self.rows, dtype=np.int32), 'l': np.arange(self.rows), 'd': np.random.rand(self.rows)})
+        cost = timeit(lambda: self.sess.upload({'t': df}))
+        print('upload {} rows of int, long and double: {:.3f}s'.format(self.rows, cost))
+        cost = timeit(lambda: self.sess.run('size', df['d'].values))
+        print('pass {} doubles as a function argument: {:.3f}s'.format(self.rows, cost))
+        self.assertEqual(self.sess.run('exec sum(l) from t'), df['l'].sum())
+
+    def test_download_numeric(self):
+        native = ddb.session(enablePickle=False)
+        native.connect('localhost', 9921, 'admin', '123456')
+        script = 't = table(1..{0} as i, long(1..{0}) as l, rand(1.0, {0}) as d)'.format(self.rows)
+        for name, sess in (('pickle', self.sess), ('native', native)):
+            sess.run(script)
+            cost = timeit(lambda: sess.run('t'))
+            print('download {} rows of int, long and double ({}): {:.3f}s'.format(self.rows, name, cost))
+
+    def test_download_string(self):
+        # strings are parsed out of the socket buffer, which grows while the reads keep filling it
+        native = ddb.session(enablePickle=False)
+        native.connect('localhost', 9921, 'admin', '123456')
+        native.run('t = table(take("sym" + string(1..1000), {0}) as s, 1..{0} as i)'.format(self.rows))
+        cost = timeit(lambda: native.run('t'), repeat=3)
+        print('download {} rows of string and int (native): {:.3f}s'.format(self.rows, cost))
+
+    def test_download_nulls(self):
+        self.sess.run('t = table(take(1 NULL 3, {0}) as i, take(1l NULL 3l, {0}) as l)'.format(self.rows))
+        for kwargs in ({}, {'nullableDtype': True}):
+            cost = timeit(lambda: self.sess.run('t', **kwargs))
+            print('download {} rows with nulls {}: {:.3f}s'.format(self.rows, kwargs, cost))
+
+    def test_download_symbol(self):
+        native = ddb.session(enablePickle=False)
+        native.connect('localhost', 9921, 'admin', '123456')
+        script = 't = table(symbol(take("sym" + string(1..1000), {0})) as s)'.format(self.rows)
+        native.run(script)
+        self.sess.run(script)
+        for kwargs in ({}, {'symbolAsCategory': True}):
+            cost = timeit(lambda: native.run('t', **kwargs))
+            print('download {} rows of symbol {}: {:.3f}s'.format(self.rows, kwargs, cost))
+        cost = timeit(lambda: self.sess.run('t'))
+        print('download {} rows of symbol (pickle): {:.3f}s'.format(self.rows, cost))
+
+    def test_download_temporal(self):
+        native = ddb.session(enablePickle=False)
+        native.connect('localhost', 9921, 'admin', '123456')
+        native.run('t = table(take(2012.01.01 + 0..1000 join NULL, {0}) as d, take(2012.01M + 0..100, {0}) as m, take(13:30:10 + 0..1000, {0}) as s)'.format(self.rows))
+        cost = timeit(lambda: native.run('t'))
+        print('download {} rows of date, month and second: {:.3f}s'.format(self.rows, cost))
+
+    def test_download_parallel(self):
+        # 30 columns that all need a fill pass: ints with nulls, doubles with nulls and timestamps
+        native = ddb.session(enablePickle=False)
+        native.connect('localhost', 9921, 'admin', '123456')
+        native.run('n = {0}; t = table(take(1 2 NULL, n) as c0)'.format(self.rows))
+        native.run('for (i in 1:10) { t[`c + string(i)] = take(1 2 NULL, n) }')
+        native.run('for (i in 10:20) { t[`c + string(i)] = take(1.5 NULL, n) }')
+        native.run('for (i in 20:30) { t[`c + string(i)] = take(2012.01.01T00:00:00.000 + 0..1000, n) }')
+        cost = timeit(lambda: native.run('t'), repeat=3)
+        print('download {} rows x 30 columns: {:.3f}s'.format(self.rows, cost))
+
+    def test_pickle_frames(self):
+        # results of mixed size on one connection, the frame buffer is reused between runs
+        self.sess.run('big = table(1..{0} as i, rand(1.0, {0}) as d); small = table(1..100 as i, rand(1.0, 100) as d)'.format(self.rows))
+        cost = timeit(lambda: [self.sess.run(name) for name in ('big', 'small') * 5], repeat=3)
+        print('download 5 x ({} + 100) rows on the pickle path: {:.3f}s'.format(self.rows, cost))
+
+    def test_pipelined_decode(self):
+        # decoding overlaps with the transfer, the gain grows with the time spent on the wire
+        self.sess.run('t = table(1..{0} as i, rand(1.0, {0}) as d, take(`a`b`c, {0}) as s)'.format(self.rows))
+        for kwargs in ({}, {'pipelinedDecode': True}):
+            cost = timeit(lambda: self.sess.run('t', **kwargs), repeat=3)
+            print('download {} rows on the pickle path {}: {:.3f}s'.format(self.rows, kwargs, cost))
+
+    def test_string_column(self):
+        ascii = np.array(['sym{}'.format(i % 1000) for i in range(self.rows)], dtype='object')
+        unicode = np.array(['\u80a1\u7968{}'.format(i % 1000) for i in range(self.rows)], dtype='object')
+        for name, col in (('ascii', ascii), ('unicode', unicode)):
+            df = pd.DataFrame({'s': col})
+            cost = timeit(lambda: self.sess.upload({'t': df}))
+            print('upload {} rows, {} string column: {:.3f}s'.format(self.rows, name, cost))
+        self.assertEqual(self.sess.run('exec count(*) from t'), self.rows)
+
+    def test_wide_frame(self):
+        # 200+ numeric columns with nulls are filled in parallel with the GIL released
+        rows = self.rows // 100
+        data = np.random.rand(rows)
+        data[::100] = np.nan
+        df = pd.DataFrame({'c{}'.format(i): data for i in range(256)})
+        cost = timeit(lambda: self.sess.upload({'t': df}))
+        print('upload {} rows x {} columns: {:.3f}s'.format(rows, len(df.columns), cost))
+        self.assertEqual(self.sess.run('exec count(*) from t'), rows)
+
+    def test_download_wide_frame(self):
+        # the native protocol builds the DataFrame in toPython, pickle lets pandas rebuild it
+        native = ddb.session(enablePickle=False)
+        native.connect('localhost', 9921, 'admin', '123456')
+        rows = self.rows // 100
+        for cols in (10, 100, 1000):
+            native.run('t = table(1..{0} as c0)'.format(rows))
+            native.run('for (i in 1:{0}) {{ t[`c + string(i)] = rand(1.0, {1}) }}'.format(cols, rows))
+            cost = timeit(lambda: native.run('t'))
+            print('download {} rows x {} columns: {:.3f}s'.format(rows, cols, cost))
+            self.assertEqual(native.run('t').shape, (rows, cols))
+
+    def test_repeated_schema(self):
+        # the same small object-column schema uploaded over and over hits the schema cache
+        df = pd.DataFrame({'sym': ['s{}'.format(i % 10) for i in range(1000)], 'note': ['x'] * 1000, 'v': np.arange(1000)})
+        cost = timeit(lambda: [self.sess.upload({'t': df}) for _ in range(1000)], repeat=3)
+        print('upload a 1000-row frame 1000 times: {:.3f}s'.format(cost))
+
+
+    def test_array_vector(self):
+        # level-2 snapshots: 10 price levels per row
+        rows = 1000000
+        prices = np.random.rand(rows, 10)
+        df = pd.DataFrame({'id': np.arange(rows), 'bid': list(prices)})
+        cost = timeit(lambda: self.sess.upload({'t': df}))
+        print('upload {} rows with a column of ndarray rows: {:.3f}s'.format(rows, cost))
+        cost = timeit(lambda: self.sess.upload({'av': ddb.ArrayVector(prices)}))
+        print('upload {} rows from a 2-D array: {:.3f}s'.format(rows, cost))
+        self.assertEqual(self.sess.run('rows(av)'), rows)
+
+    def test_unix_socket_round_trip(self):
+        # small runs against a local stand-in server, where the transport is most of the cost
+        servers = (('tcp', StandInServer()), ('unix', StandInServer(StandInServer.temp_path())))
+        for name, server in servers:
+            sess = ddb.session()
+            sess.connect('127.0.0.1', server.port, unixSocket=server.path)
+            cost = timeit(lambda: [sess.run('1 + 1') for _ in range(10000)], repeat=3)
+            print('10000 small runs over {}: {:.3f}s'.format(name, cost))
+            sess.close()
+            server.close()
+
+    def test_run_pipelined(self):
+        # a stand-in server that answers 2ms after each request, like a cross-region link
+        server = StandInServer(delay=0.002)
+        sess = ddb.session()
+        sess.connect('127.0.0.1', server.port)
+        scripts = ['1 + 1'] * 500
+        cost = timeit(lambda: [sess.run(script) for script in scripts], repeat=3)
+        print('500 small runs one by one over a 2ms link: {:.3f}s'.format(cost))
+        cost = timeit(lambda: sess.runPipelined(scripts), repeat=3)
+        print('500 small runs pipelined over a 2ms link: {:.3f}s'.format(cost))
+        sess.close()
+        server.close()
+
+    def test_pool_event_loop(self):
+        # 64 connections on worker threads or on 2 epoll threads, against a local stand-in server
+        server = StandInServer()
+        for loops in (0, 2):
+            pool = ddb.DBConnectionPool('127.0.0.1', server.port, 64, eventLoopThreads=loops)
+
+            async def runAll():
+                return await asyncio.gather(*[pool.run('1 + 1') for _ in range(10000)])
+            cost = timeit(lambda: asyncio.run(runAll()), repeat=3)
+            print('10000 pool tasks with eventLoopThreads={}: {:.3f}s'.format(loops, cost))
+            pool.shutDown()
+        server.close()
+
+    @unittest.skipIf(pa is None, 'pyarrow is not installed')
+    def test_arrow_table(self):
+        # fixed-width Arrow columns without nulls are serialized from the Arrow buffers
+        df = pd.DataFrame({'d': np.random.rand(self.rows), 'l': np.arange(self.rows),
+                           'ts': np.arange(self.rows, dtype='datetime64[ns]')})
+        tbl = pa.Table.from_pandas(df, preserve_index=False)
+        cost = timeit(lambda: self.sess.upload({'t': df}))
+        print('upload {} rows from pandas: {:.3f}s'.format(self.rows, cost))
+        cost = timeit(lambda: self.sess.upload({'t': tbl}))
+        print('upload {} rows from pyarrow: {:.3f}s'.format(self.rows, cost))
+        cost = timeit(lambda: self.sess.run('t', output='arrow'))
+        print('download {} rows to pyarrow: {:.3f}s'.format(self.rows, cost))
+        cost = timeit(lambda: self.sess.run('t'))
+        print('download {} rows to pandas: {:.3f}s'.format(self.rows, cost))
+
+if __name__ == '__main__':
+    unittest.main()